@@ -0,0 +1,290 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file aiyagari.cpp
+///
+/// @brief File containing main function for the Aiyagari model.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+
+using namespace std;
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute the supply of capital at given prices.
+///
+/// @details This function solves the household problem at interest rate r
+/// and wage w by value function iteration with @link vfStepCash @endlink,
+/// starting from V, computes the stationary distribution of the resulting
+/// policy with @link statDist @endlink, starting from mu, and returns
+/// aggregate asset holdings. Both V and mu are left at their new values,
+/// so that the next call starts from the solution at the previous prices.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] A Grid of asset values.
+/// @param [in] E Grid of labor efficiency values.
+/// @param [in] P Labor efficiency transition matrix.
+/// @param [in] r Interest rate.
+/// @param [in] w Wage.
+/// @param [in,out] V Value function.
+/// @param [out] G Policy function.
+/// @param [in,out] mu Stationary distribution over (a,e).
+/// @param [out] nIter Number of household and distribution iterations.
+///
+/// @returns Aggregate supply of capital.
+///
+//////////////////////////////////////////////////////////////////////////////
+static REAL kSupply(const parameters& param, const VectorXR& A,
+		    const VectorXR& E, const MatrixXR& P, const REAL& r,
+		    const REAL& w, MatrixXR& V, MatrixXi& G, VectorXR& mu,
+		    Vector2i& nIter)
+{
+  const int nk = param.nk;
+  const int nz = param.nz;
+
+  // household problem
+  MatrixXR cash = ((1+r)*A)*RowVectorXR::Ones(nz) +
+    VectorXR::Ones(nk)*(w*E).transpose();
+  MatrixXR V1(nk, nz);
+  REAL diff = 1.0;
+  nIter(0) = 0;
+  while(fabs(diff) > param.tol){
+    vfStepCash(param, A, cash, P, V, V1, G);
+    diff = (V1-V).array().abs().maxCoeff();
+    V.swap(V1);
+    ++nIter(0);
+  }
+
+  // stationary distribution and aggregate assets
+  MatrixXR Ap(nk, nz);
+  for(int j = 0 ; j < nz ; ++j){
+    for(int i = 0 ; i < nk ; ++i) Ap(i,j) = A(G(i,j));
+  }
+  SpMatR T;
+  transOp(param, A, P, Ap, T);
+  nIter(1) = statDist(T, 5, 1e-12, 1000000, mu);
+  return mu.dot(Map<const VectorXR>(Ap.data(), nk*nz));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @fn main()
+///
+/// @brief Main function for the Aiyagari model.
+///
+/// @details This function computes the stationary equilibrium of the
+/// Aiyagari (1994) model: households with the preferences of
+/// `../parameters.txt' face idiosyncratic labor efficiency e, whose log is
+/// an AR1 with persistence rhoE and innovation standard deviation sigmaE
+/// (discretized with nz states by the method of the parameter file and
+/// normalized to mean one), and save in capital on a grid of nk values
+/// from zero (the borrowing limit) to aMax times the steady-state capital
+/// of the representative agent model. The firm has the technology of the
+/// growth model, so that the wage is a function of the interest rate.
+///
+/// @details The interest rate which clears the capital market is found in
+/// (-delta, 1/beta-1), where the excess supply of capital changes sign, by
+/// the Illinois variant of regula falsi, with bisection until both ends of
+/// the bracket have been evaluated. Each evaluation (see @link kSupply
+/// @endlink) starts the household problem and the stationary distribution
+/// from the solution at the previous rate. The search stops when the
+/// bracket is narrower than 1e-10 or the excess supply is below tol times
+/// the demand for capital. If the excess supply does not change sign
+/// within 100 evaluations, no equilibrium has been bracketed and nothing
+/// is written.
+///
+/// @details Usage: `./aiyagari [rhoE sigmaE aMax [nT dZ rhoZ]]' (default
+/// 0.9 0.2 4, and no transition; dZ and rhoZ default to -0.01 and 0.9).
+/// `aiyagariCPP.dat' holds the interest rate, wage and capital, the number
+/// of outer iterations, the solution time and the mean time per outer
+/// iteration; `aiyagariIterCPP.dat' holds one line per outer iteration
+/// (interest rate, excess supply, household iterations, distribution
+/// iterations and time); the stationary distribution is written to
+/// `distAiyCPP.bin' and the policy function to `polFunAiyCPP.dat' in the
+/// format of `main'.
+///
+/// @details If nT > 0, the path of the economy after TFP unexpectedly
+/// changes to 1+dZ and returns to one at rate rhoZ is then computed over
+/// nT periods from the stationary equilibrium (see @link transPath
+/// @endlink), until the path of capital changes by less than 1e-3 times
+/// the steady-state capital. Since the policies are discrete, the implied
+/// path jumps with small changes in prices, and the iteration does not
+/// settle much below this (about 5e-4 with nk = 256). `transCPP.dat' holds
+/// one line per period (TFP, capital, interest rate and wage), and
+/// `transIterCPP.dat' the number of iterations, the final difference, the
+/// time and the bytes of value and policy functions stored and of nT value
+/// functions.
+///
+/// @returns 0 upon successful completion, 1 otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+
+  // admin
+  int i, j;
+  double tic = curr_second(); // Start time
+
+  // Load parameters
+  parameters params;
+  params.load("../parameters.txt");
+  parameters paramE = params;
+  paramE.mu = 0.0;
+  paramE.rho = argc > 3 ? atof(argv[1]) : 0.9;
+  paramE.sigma = argc > 3 ? atof(argv[2]) : 0.2;
+  const REAL aMax = argc > 3 ? atof(argv[3]) : 4.0;
+  const int nT = argc > 4 ? atoi(argv[4]) : 0;
+  const REAL dZ = argc > 5 ? atof(argv[5]) : -0.01;
+  const REAL rhoZ = argc > 6 ? atof(argv[6]) : 0.9;
+  const int nk = params.nk;
+  const int nz = params.nz;
+  const REAL alpha = params.alpha;
+  const REAL beta = params.beta;
+  const REAL delta = params.delta;
+  const REAL eta = params.eta;
+
+  // labor efficiency, normalized so that aggregate labor is one
+  VectorXR E(nz);
+  MatrixXR P(nz, nz);
+  ar1(paramE, E, P);
+  RowVectorXR piE = RowVectorXR::Constant(nz, 1.0/nz);
+  for(int it = 0 ; it < 10000 ; ++it) piE = piE*P;
+  E /= piE.dot(E);
+
+  // asset grid from the borrowing limit
+  const REAL kRA = pow((1/alpha)*((1/beta)-1+delta),1/(alpha-1));
+  const VectorXR A = VectorXR::LinSpaced(nk, 0.0, aMax*kRA);
+
+  // initial value function: consume labor income forever
+  MatrixXR V(nk, nz);
+  MatrixXi G(nk, nz);
+  VectorXR mu;
+  const REAL w0 = (1-alpha)*pow(kRA,alpha);
+  for(j = 0 ; j < nz ; ++j){
+    V.col(j).setConstant(pow(w0*E(j),1-eta)/((1-eta)*(1-beta)));
+  }
+
+  // bracketed search for the market-clearing interest rate
+  const int maxOuter = 100;
+  MatrixXR hist(maxOuter, 5);
+  REAL rlo = -delta, rhi = 1/beta-1, flo = 0.0, fhi = 0.0;
+  bool haveLo = false, haveHi = false;
+  int side = 0, nOuter = 0;
+  REAL r = 0.0, w = 0.0, Kd = 0.0, f;
+  Vector2i nIter;
+  while(nOuter < maxOuter){
+    double ticOuter = curr_second();
+
+    // next guess: Illinois step inside the bracket, bisection otherwise
+    if(haveLo && haveHi) r = (rlo*fhi - rhi*flo)/(fhi - flo);
+    if(!(haveLo && haveHi) || r <= rlo || r >= rhi) r = 0.5*(rlo+rhi);
+
+    // firm's demand for capital and wage, and excess supply
+    Kd = pow(alpha/(r+delta),1/(1-alpha));
+    w = (1-alpha)*pow(Kd,alpha);
+    f = kSupply(params, A, E, P, r, w, V, G, mu, nIter) - Kd;
+
+    hist(nOuter,0) = r;
+    hist(nOuter,1) = f;
+    hist(nOuter,2) = nIter(0);
+    hist(nOuter,3) = nIter(1);
+    hist(nOuter,4) = curr_second() - ticOuter;
+    ++nOuter;
+
+    // update the bracket (halving the retained value when the same end
+    // moves twice in a row)
+    if(f < 0){
+      rlo = r; flo = f; haveLo = true;
+      if(side == -1) fhi /= 2;
+      side = -1;
+    } else {
+      rhi = r; fhi = f; haveHi = true;
+      if(side == 1) flo /= 2;
+      side = 1;
+    }
+    if(fabs(f) < params.tol*Kd || rhi-rlo < 1e-10) break;
+  }
+  double solTime = curr_second() - tic;
+  if(!(haveLo && haveHi)){
+    cerr << "Excess supply of capital did not change sign" << endl;
+    return 1;
+  }
+
+  // write to file (column major)
+  ofstream fileAiy, fileIter, filePolicy;
+  filePolicy.precision(10);
+  fileAiy.precision(10);
+  fileIter.precision(10);
+  fileAiy.open("aiyagariCPP.dat");
+  fileIter.open("aiyagariIterCPP.dat");
+  filePolicy.open("polFunAiyCPP.dat");
+  fileAiy << r << endl;
+  fileAiy << w << endl;
+  fileAiy << Kd << endl;
+  fileAiy << nOuter << endl;
+  fileAiy << solTime << endl;
+  fileAiy << hist.col(4).head(nOuter).mean() << endl;
+  fileIter << hist.topRows(nOuter) << endl;
+  filePolicy << nk << endl;
+  filePolicy << nz << endl;
+  for(j = 0 ; j < nz ; ++j){
+    for(i = 0 ; i < nk ; ++i) filePolicy << G(i,j) << endl;
+  }
+  fileAiy.close();
+  fileIter.close();
+  filePolicy.close();
+  writeBin("distAiyCPP.bin", Map<MatrixXR>(mu.data(), nk, nz));
+
+  // transition after an unexpected change in TFP
+  if(nT > 0){
+    tic = curr_second();
+    VectorXR Zt(nT), Kt = VectorXR::Constant(nT, Kd);
+    for(int t = 0 ; t < nT ; ++t) Zt(t) = 1 + dZ*pow(rhoZ,t);
+    REAL diff;
+    const int nIterT = transPath(params, A, E, P, Zt, V, mu, 1e-3*Kd,
+				 1000, Kt, diff);
+    const double transTime = curr_second() - tic;
+    const int s = (int)ceil(sqrt((double)nT));
+    const REAL bytesStored = (REAL)nk*nz*((nT + s - 1)/s*sizeof(REAL) +
+					  s*sizeof(int));
+    ofstream fileTrans, fileTransIter;
+    fileTrans.precision(10);
+    fileTransIter.precision(10);
+    fileTrans.open("transCPP.dat");
+    fileTransIter.open("transIterCPP.dat");
+    for(int t = 0 ; t < nT ; ++t){
+      fileTrans << Zt(t) << " " << Kt(t) << " "
+		<< alpha*Zt(t)*pow(Kt(t),alpha-1) - delta << " "
+		<< (1-alpha)*Zt(t)*pow(Kt(t),alpha) << endl;
+    }
+    fileTransIter << nIterT << endl;
+    fileTransIter << diff << endl;
+    fileTransIter << transTime << endl;
+    fileTransIter << bytesStored << endl;
+    fileTransIter << (REAL)nk*nz*nT*sizeof(REAL) << endl;
+    fileTrans.close();
+    fileTransIter.close();
+  }
+
+  return 0;
+
+}
@@ -2,7 +2,7 @@
 ///
 /// @file ar1.cpp
 ///
-/// @brief File containing AR1 function for the VFI problem.
+/// @brief File containing AR1 discretization functions for the VFI problem.
 ///
 /// @author Eric M. Aldrich \n
 ///         ealdrich@ucsc.edu
@@ -21,16 +21,20 @@
 #include "global.h"
 #include <math.h>
 #include <Eigen/Dense>
+#include <Eigen/Eigenvalues>
+#include <map>
+#include <vector>
+#include <utility>
 
+using namespace std;
 using namespace Eigen;
 
+/// Maximum number of discretizations kept by ar1.
+static const size_t cacheSize = 64;
+
 //////////////////////////////////////////////////////////////////////////////
 ///
-/// @brief Function to compute discrete AR1 approximation values and
-/// transition matrix.
-///
-/// @details This function that computes a discrete AR1 approximation and
-/// transition matrix using the method of Tauchen (1986).
+/// @brief Function to compute the Tauchen (1986) discretization.
 ///
 /// @param [in] param Object of class parameters.
 /// @param [out] Z Grid of AR1 values.
@@ -39,7 +43,7 @@ using namespace Eigen;
 /// @returns Void.
 ///
 //////////////////////////////////////////////////////////////////////////////
-void ar1(const parameters& param, VectorXR& Z, MatrixXR& P)
+static void tauchen(const parameters& param, VectorXR& Z, MatrixXR& P)
 {
 
   // Basic parameters
@@ -71,3 +75,145 @@ void ar1(const parameters& param, VectorXR& Z, MatrixXR& P)
     P.col(nz-1) = ones - P.leftCols(nz-1).rowwise().sum();
   }
 }
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute the Tauchen and Hussey (1991) discretization.
+///
+/// @details The grid of log TFP consists of the Gauss-Hermite quadrature
+/// nodes for the conditional distribution of the innovation, centered at
+/// the unconditional mean, and the transition probabilities are the
+/// quadrature weights reweighted by the ratio of the conditional density
+/// to the density at the mean, normalized to sum to one. The nodes and
+/// weights are computed by the Golub-Welsch algorithm. lambda is not used.
+///
+/// @param [in] param Object of class parameters.
+/// @param [out] Z Grid of AR1 values.
+/// @param [out] P AR1 transition matrix values.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+static void tauchenHussey(const parameters& param, VectorXR& Z, MatrixXR& P)
+{
+  const int nz = param.nz;
+  const REAL rho = param.rho;
+  const REAL sigma = param.sigma;
+  const REAL mu_z = param.mu/(1-rho);
+
+  // Gauss-Hermite nodes and (normalized) weights for weight exp(-x^2)
+  MatrixXR J = MatrixXR::Zero(nz, nz);
+  for(int ix = 1 ; ix < nz ; ++ix) J(ix,ix-1) = J(ix-1,ix) = sqrt(0.5*ix);
+  SelfAdjointEigenSolver<MatrixXR> eig(J);
+  const VectorXR x = eig.eigenvalues();
+  const VectorXR w = eig.eigenvectors().row(0).transpose().array().square();
+
+  // grid of log TFP and reweighted transition probabilities
+  const VectorXR z = (sqrt(2.0)*sigma*x).array() + mu_z;
+  REAL dev, dev0;
+  for(int ix = 0 ; ix < nz ; ++ix){
+    for(int jx = 0 ; jx < nz ; ++jx){
+      dev = z(jx) - (1-rho)*mu_z - rho*z(ix);
+      dev0 = z(jx) - mu_z;
+      P(ix,jx) = w(jx)*exp(-(dev*dev - dev0*dev0)/(2*sigma*sigma));
+    }
+    P.row(ix) /= P.row(ix).sum();
+  }
+  Z = z.array().exp().matrix();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute the Rouwenhorst (1995) discretization.
+///
+/// @details The grid of log TFP is equally spaced on the unconditional mean
+/// plus or minus sqrt(nz-1) unconditional standard deviations, and the
+/// transition matrix is built recursively from the two state chain with
+/// p = q = (1+rho)/2 (Kopecky and Suen, 2010). The discrete process matches
+/// the persistence and the unconditional and conditional variances of the
+/// AR1 exactly for any nz, so that highly persistent processes need far
+/// fewer states than with Tauchen. lambda is not used.
+///
+/// @param [in] param Object of class parameters.
+/// @param [out] Z Grid of AR1 values.
+/// @param [out] P AR1 transition matrix values.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+static void rouwenhorst(const parameters& param, VectorXR& Z, MatrixXR& P)
+{
+  const int nz = param.nz;
+  const REAL rho = param.rho;
+  const REAL sigma_z = param.sigma/sqrt(1-rho*rho);
+  const REAL mu_z = param.mu/(1-rho);
+  const REAL psi = sqrt((REAL)(nz-1))*sigma_z;
+  const REAL p = (1+rho)/2;
+
+  // recursion over the number of states
+  MatrixXR Pn(1, 1), Pm;
+  Pn(0,0) = 1.0;
+  for(int n = 2 ; n <= nz ; ++n){
+    Pm = MatrixXR::Zero(n, n);
+    Pm.topLeftCorner(n-1, n-1) += p*Pn;
+    Pm.topRightCorner(n-1, n-1) += (1-p)*Pn;
+    Pm.bottomLeftCorner(n-1, n-1) += (1-p)*Pn;
+    Pm.bottomRightCorner(n-1, n-1) += p*Pn;
+    Pm.middleRows(1, n-2) /= 2;
+    Pn.swap(Pm);
+  }
+  P = Pn;
+  Z = (VectorXR::LinSpaced(nz, mu_z-psi, mu_z+psi)).array().exp().matrix();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute discrete AR1 approximation values and
+/// transition matrix.
+///
+/// @details This function computes a discrete AR1 approximation and
+/// transition matrix using the method selected by param.zMethod: Tauchen
+/// (1986), Tauchen and Hussey (1991) or Rouwenhorst (1995). Results are
+/// cached in memory, keyed by (mu, rho, sigma, lambda, nz, method), so
+/// that repeated calibrations (e.g. in sweeps and estimation) which share
+/// the TFP process do not recompute it. The cache is safe to use from
+/// several OpenMP threads.
+///
+/// @param [in] param Object of class parameters.
+/// @param [out] Z Grid of AR1 values.
+/// @param [out] P AR1 transition matrix values.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void ar1(const parameters& param, VectorXR& Z, MatrixXR& P)
+{
+  static map< vector<REAL>, pair<VectorXR, MatrixXR> > cache;
+  const REAL k[] = {param.mu, param.rho, param.sigma, param.lambda,
+		    (REAL)param.nz, (REAL)param.zMethod};
+  const vector<REAL> key(k, k+6);
+  bool hit = false;
+#pragma omp critical(ar1Cache)
+  {
+    map< vector<REAL>, pair<VectorXR, MatrixXR> >::const_iterator it =
+      cache.find(key);
+    if(it != cache.end()){
+      Z = it->second.first;
+      P = it->second.second;
+      hit = true;
+    }
+  }
+  if(hit) return;
+
+  Z.resize(param.nz);
+  P.resize(param.nz, param.nz);
+  if(param.zMethod == zTauchenHussey) tauchenHussey(param, Z, P);
+  else if(param.zMethod == zRouwenhorst) rouwenhorst(param, Z, P);
+  else tauchen(param, Z, P);
+
+#pragma omp critical(ar1Cache)
+  {
+    if(cache.size() >= cacheSize) cache.clear();
+    cache[key] = make_pair(Z, P);
+  }
+}
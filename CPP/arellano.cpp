@@ -0,0 +1,164 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file arellano.cpp
+///
+/// @brief File containing main function for the sovereign default model.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+
+using namespace std;
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @fn main()
+///
+/// @brief Main function for the sovereign default model.
+///
+/// @details This function solves the sovereign default model of Arellano
+/// (2008) (see @link vfStepDef @endlink) with her calibration: discount
+/// factor 0.953, interest rate 0.017, probability of regaining market
+/// access 0.282 and output under default capped at 0.969 times mean
+/// output. Risk aversion eta and the tolerance are those of
+/// `../parameters.txt'. Log endowment is an AR1 with persistence 0.945 and
+/// innovation standard deviation 0.025, discretized with ny states by the
+/// method of the parameter file, and bond holdings lie on a grid of nb
+/// values from bMin to zero. Value functions and bond prices are iterated
+/// jointly until the largest change in either is below tol, or for at most
+/// 10000 iterations.
+///
+/// @details Usage: `./arellano [nb [ny [bMin]]]' (default 200 21 -0.35).
+/// `arellanoCPP.dat' holds the solution time, the number of iterations,
+/// the mean time per iteration, the final difference and the fraction of
+/// states in which the sovereign defaults; the value and policy functions
+/// and the bond prices q(b',y) are written to `valFunDefCPP.dat',
+/// `polFunDefCPP.dat' and `priceDefCPP.dat' in the format of `main'.
+///
+/// @returns 0 upon successful completion, 1 otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+
+  // admin
+  int i, j;
+  double tic = curr_second(); // Start time
+
+  // Load parameters
+  parameters params;
+  params.load("../parameters.txt");
+  params.beta = 0.953;
+  const REAL r = 0.017;
+  const REAL theta = 0.282;
+  const REAL h = 0.969;
+  const int nb = argc > 1 ? atoi(argv[1]) : 200;
+  const REAL bMin = argc > 3 ? atof(argv[3]) : -0.35;
+  parameters paramY = params;
+  paramY.mu = 0.0;
+  paramY.rho = 0.945;
+  paramY.sigma = 0.025;
+  paramY.nz = argc > 2 ? atoi(argv[2]) : 21;
+  const int ny = paramY.nz;
+  const REAL eta = params.eta;
+  const REAL beta = params.beta;
+  if(nb < 2 || ny < 2 || bMin >= 0){
+    cerr << "Need nb >= 2, ny >= 2 and bMin < 0" << endl;
+    return 1;
+  }
+
+  // endowment and output under default
+  VectorXR Y(ny);
+  MatrixXR P(ny, ny);
+  ar1(paramY, Y, P);
+  RowVectorXR piY = RowVectorXR::Constant(ny, 1.0/ny);
+  for(int it = 0 ; it < 10000 ; ++it) piY = piY*P;
+  const VectorXR Yd = Y.cwiseMin(h*piY.dot(Y));
+
+  // bond grid, ending at zero
+  const VectorXR B = VectorXR::LinSpaced(nb, bMin, 0.0);
+  const int i0 = nb-1;
+
+  // initial values: consume the endowment forever and never default
+  MatrixXR V0(nb, ny), V(nb, ny), D0 = MatrixXR::Zero(nb, ny), D(nb, ny);
+  MatrixXR q0 = MatrixXR::Constant(nb, ny, 1/(1+r)), q;
+  VectorXR Vd0(ny), Vd(ny);
+  MatrixXi G(nb, ny);
+  for(j = 0 ; j < ny ; ++j){
+    V0.col(j).setConstant(pow(Y(j),1-eta)/((1-eta)*(1-beta)));
+    Vd0(j) = pow(Yd(j),1-eta)/((1-eta)*(1-beta));
+  }
+
+  // joint iteration on values and prices
+  const int maxIter = 10000;
+  REAL diff = 1.0;
+  int iter = 0;
+  double tSweep = curr_second();
+  while(fabs(diff) > params.tol && iter < maxIter){
+    vfStepDef(params, r, theta, B, Y, Yd, P, i0, V0, Vd0, D0, V, Vd, D, q, G);
+    diff = (V-V0).array().abs().maxCoeff();
+    diff = max(diff, (Vd-Vd0).array().abs().maxCoeff());
+    diff = max(diff, (q-q0).array().abs().maxCoeff());
+    V0 = V;
+    Vd0 = Vd;
+    D0 = D;
+    q0 = q;
+    ++iter;
+  }
+  tSweep = (curr_second() - tSweep)/iter;
+  double solTime = curr_second() - tic;
+
+  // write to file (column major)
+  ofstream fileStats, fileValue, filePolicy, filePrice;
+  fileStats.precision(10);
+  fileValue.precision(10);
+  filePolicy.precision(10);
+  filePrice.precision(10);
+  fileStats.open("arellanoCPP.dat");
+  fileValue.open("valFunDefCPP.dat");
+  filePolicy.open("polFunDefCPP.dat");
+  filePrice.open("priceDefCPP.dat");
+  fileStats << solTime << endl;
+  fileStats << iter << endl;
+  fileStats << tSweep << endl;
+  fileStats << diff << endl;
+  fileStats << D.mean() << endl;
+  fileValue << nb << endl;
+  fileValue << ny << endl;
+  filePolicy << nb << endl;
+  filePolicy << ny << endl;
+  filePrice << nb << endl;
+  filePrice << ny << endl;
+  for(j = 0 ; j < ny ; ++j){
+    for(i = 0 ; i < nb ; ++i){
+      fileValue << V(i,j) << endl;
+      filePolicy << G(i,j) << endl;
+      filePrice << q(i,j) << endl;
+    }
+  }
+  fileStats.close();
+  fileValue.close();
+  filePolicy.close();
+  filePrice.close();
+
+  return 0;
+
+}
@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file binaryMaxGuard.cpp
+///
+/// @brief File containing function to compute maximum of Bellman objective
+/// via binary search, guarded against nonconcavity.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+#include <math.h>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute maximum of Bellman objective via binary
+/// search, guarded against nonconcavity.
+///
+/// @details This function performs the binary search of @link binaryMax
+/// @endlink and checks that the slopes of the objective which it computes
+/// are consistent with concavity: the slope at each midpoint must lie
+/// between the slopes at the two ends of the current bracket, and the
+/// final three points must have a nonpositive second difference. These
+/// checks reuse the values computed by the search, apart from one
+/// evaluation of the objective at the end. If a check fails, the
+/// objective is not concave and the maximum is found instead by @link
+/// gridMax @endlink over the whole subgrid.
+///
+/// @param [in] klo Lower index of the capital grid to begin search.
+/// @param [in] nksub Number of points in the capital grid to include in
+/// search.
+/// @param [in] ydepK value of output plus depreciated capital.
+/// @param [in] eta Coefficient of relative risk aversion.
+/// @param [in] beta Time discount factor.
+/// @param [in] K Grid of capital values.
+/// @param [in] Exp Expected value function continuation values.
+/// @param [out] V Updated value function.
+/// @param [out] G Updated policy function.
+///
+/// @returns true if concavity was violated and the grid search was used,
+/// false otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+bool binaryMaxGuard(const int& klo, const int& nksub, const REAL& ydepK,
+		    const REAL eta, const REAL beta, const VectorXR& K,
+		    const Ref<const VectorXR>& Exp, REAL& V, int& G)
+{
+
+  // all points are evaluated on grids of three values or fewer
+  if(nksub <= 3){
+    binaryMax(klo, nksub, ydepK, eta, beta, K, Exp, V, G);
+    return false;
+  }
+
+  // binary search, keeping the slopes at the ends of the bracket
+  int kslo = 0;
+  int kshi = nksub-1;
+  int ksmid1, ksmid2;
+  REAL w1, w2, w3, s;
+  REAL sLo = HUGE_VAL, sHi = -HUGE_VAL;
+  bool concave = true;
+  while(kshi-kslo > 2){
+    ksmid1 = (kslo + kshi)/2;
+    ksmid2 = ksmid1+1;
+    w1 = pow(ydepK-K(klo+ksmid1),1-eta)/(1-eta) + beta*Exp(ksmid1);
+    w2 = pow(ydepK-K(klo+ksmid2),1-eta)/(1-eta) + beta*Exp(ksmid2);
+    s = w2 - w1;
+    if(s > sLo || s < sHi) concave = false;
+    if(s > 0){
+      kslo = ksmid1;
+      sLo = s;
+    } else {
+      kshi = ksmid2;
+      sHi = s;
+    }
+  }
+
+  // three remaining values, one of which is w1 or w2
+  if(s > 0){
+    w3 = pow(ydepK-K(klo+kshi),1-eta)/(1-eta) + beta*Exp(kshi);
+    if(w3 - w2 > s) concave = false;
+    if(concave){
+      if(w2 > w3){
+	V = w2; G = klo+kslo+1;
+      } else {
+	V = w3; G = klo+kshi;
+      }
+    }
+  } else {
+    w3 = pow(ydepK-K(klo+kslo),1-eta)/(1-eta) + beta*Exp(kslo);
+    if(w1 - w3 < s) concave = false;
+    if(concave){
+      if(w3 > w1){
+	V = w3; G = klo+kslo;
+      } else {
+	V = w1; G = klo+kslo+1;
+      }
+    }
+  }
+
+  // fallback for nonconcave objectives
+  if(!concave) gridMax(klo, nksub, ydepK, eta, beta, K, Exp, V, G);
+  return !concave;
+}
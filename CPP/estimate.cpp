@@ -0,0 +1,379 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file estimate.cpp
+///
+/// @brief File containing main function for simulated method of moments
+/// estimation.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "solver.h"
+#include <Eigen/Dense>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <math.h>
+#include <stdlib.h>
+
+using namespace std;
+using namespace Eigen;
+
+/// Number of estimated parameters (beta, rho, sigma, eta).
+static const int nTheta = 4;
+
+/// Number of simulated economies per objective evaluation.
+static const int nAgents = 500;
+
+/// Number of simulated periods used to compute moments.
+static const int nPeriods = 500;
+
+/// Number of initial simulated periods which are discarded.
+static const int nBurn = 100;
+
+/// Seed of the common random numbers used for every evaluation.
+static const unsigned long long seed = 20121023ULL;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @class smmProblem
+///
+/// @brief Object to store the moment targets and the solvers of an
+/// estimation problem.
+///
+//////////////////////////////////////////////////////////////////////////////
+class smmProblem{
+ public:
+  parameters base; ///< Calibration of the parameters which are not estimated.
+  vector<int> moment; ///< Index of each targeted moment (see simMoment).
+  VectorXR target; ///< Target values of the moments.
+  VectorXR weight; ///< Weights of the moments in the objective.
+  vector<Solver> solvers; ///< One solver per point of a batch, for warm starts.
+  int nEval; ///< Number of objective evaluations.
+  double evalTime; ///< Total time spent in objective evaluations.
+};
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to extract a moment from simulated moments.
+///
+/// @param [in] s Simulated moments.
+/// @param [in] m Index of the moment, in the order meanK, sdK, meanY, sdY,
+/// meanC, sdC, meanI, sdI, acY.
+///
+/// @returns Value of the moment.
+///
+//////////////////////////////////////////////////////////////////////////////
+static REAL simMoment(const simStats& s, const int& m)
+{
+  const REAL v[] = {s.meanK, s.sdK, s.meanY, s.sdY, s.meanC, s.sdC, s.meanI,
+		    s.sdI, s.acY};
+  return v[m];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to load moment targets.
+///
+/// @details Each line of the file has the form `name,value[,weight]',
+/// where name is one of meanK, sdK, meanY, sdY, meanC, sdC, meanI, sdI or
+/// acY. Weights default to 1.
+///
+/// @param [in] fileName Name of file storing the targets.
+/// @param [in,out] prob Estimation problem.
+///
+/// @returns true upon success, false otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+static bool loadTargets(const char* fileName, smmProblem& prob)
+{
+  const char* names[] = {"meanK", "sdK", "meanY", "sdY", "meanC", "sdC",
+			 "meanI", "sdI", "acY"};
+  ifstream fileIn(fileName);
+  if(!fileIn) return false;
+  string line, name, value, weight;
+  vector<REAL> t, w;
+  while(getline(fileIn, line)){
+    if(line.find_first_not_of(" \t\r") == string::npos) continue;
+    stringstream row(line);
+    getline(row, name, ',');
+    getline(row, value, ',');
+    if(!getline(row, weight, ',')) weight = "1";
+    name.erase(0, name.find_first_not_of(" \t"));
+    name.erase(name.find_last_not_of(" \t\r")+1);
+    int m = -1;
+    for(int ix = 0 ; ix < 9 ; ++ix) if(name == names[ix]) m = ix;
+    if(m < 0){
+      cerr << "Unknown moment: " << name << endl;
+      return false;
+    }
+    prob.moment.push_back(m);
+    t.push_back(atof(value.c_str()));
+    w.push_back(atof(weight.c_str()));
+  }
+  prob.target = Map<VectorXR>(t.data(), t.size());
+  prob.weight = Map<VectorXR>(w.data(), w.size());
+  return t.size() > 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to map unconstrained coordinates to parameter values.
+///
+/// @details beta = 1/(1+exp(-x0)), rho = tanh(x1), sigma = exp(x2) and
+/// eta = 1+exp(x3), so that the search is unconstrained while beta and
+/// rho lie in (0,1) and (-1,1), sigma is positive and eta exceeds 1 (the
+/// CRRA form is undefined at eta = 1).
+///
+/// @param [in] base Calibration of the parameters which are not estimated.
+/// @param [in] x Unconstrained coordinates.
+///
+/// @returns Object of class parameters.
+///
+//////////////////////////////////////////////////////////////////////////////
+static parameters toParam(const parameters& base, const VectorXR& x)
+{
+  parameters p = base;
+  p.beta = 1/(1+exp(-x(0)));
+  p.rho = tanh(x(1));
+  p.sigma = exp(x(2));
+  p.eta = 1+exp(x(3));
+  return p;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to map parameter values to unconstrained coordinates.
+///
+/// @param [in] p Object of class parameters.
+///
+/// @returns Unconstrained coordinates (inverse of @link toParam @endlink).
+///
+//////////////////////////////////////////////////////////////////////////////
+static VectorXR toCoord(const parameters& p)
+{
+  VectorXR x(nTheta);
+  x(0) = log(p.beta/(1-p.beta));
+  x(1) = atanh(p.rho);
+  x(2) = log(p.sigma);
+  x(3) = log(p.eta-1);
+  return x;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to evaluate the SMM objective at several points in
+/// parallel.
+///
+/// @details The points are divided among OpenMP threads. Point ix is
+/// solved by solver ix of the problem (see @link Solver @endlink), which
+/// is warm started from point ix of the previous batch, so that the warm
+/// start, and hence the objective, does not depend on the number or timing
+/// of the threads. Each model is simulated with the same random numbers
+/// (common seed) at every point, so that differences in the objective
+/// between points are not due to simulation noise. The objective
+/// is not smooth in the parameters, since the policy is discrete and the
+/// TFP grid and transition matrix move with rho and sigma, which is why it
+/// is minimized without derivatives (see @link nelderMead @endlink). It is
+/// the weighted sum of squared percent deviations of simulated from target
+/// moments.
+///
+/// @param [in,out] prob Estimation problem.
+/// @param [in] X Points to evaluate (one per column, at most
+/// prob.solvers.size()).
+/// @param [out] f Objective values.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+static void smmObjective(smmProblem& prob, const MatrixXR& X, VectorXR& f)
+{
+  const int nPoint = X.cols();
+  f.resize(nPoint);
+  double tic = curr_second();
+#pragma omp parallel for schedule(dynamic,1)
+  for(int ix = 0 ; ix < nPoint ; ++ix){
+    Solver& solver = prob.solvers[ix];
+    const parameters p = toParam(prob.base, X.col(ix));
+    solver.setParameters(p);
+    solver.solve();
+    simStats s;
+    simulate(p, solver.K(), solver.Z(), solver.P(), solver.policy(), nAgents,
+	     nPeriods, nBurn, seed, false, s);
+    REAL loss = 0.0;
+    for(size_t m = 0 ; m < prob.moment.size() ; ++m){
+      loss += prob.weight(m)*pow(simMoment(s, prob.moment[m])/prob.target(m) - 1, 2);
+    }
+    f(ix) = isfinite(loss) ? loss : HUGE_VAL;
+  }
+  prob.evalTime += curr_second() - tic;
+  prob.nEval += nPoint;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to minimize the SMM objective with a parallel Nelder-Mead
+/// simplex search.
+///
+/// @details This function implements the Nelder-Mead algorithm with the
+/// standard coefficients (reflection 1, expansion 2, contraction 1/2,
+/// shrink 1/2). The initial simplex and shrink steps are evaluated in
+/// parallel, and at every iteration the reflection, expansion and inside
+/// and outside contraction points are evaluated speculatively in a single
+/// parallel batch, so that each iteration costs one round of solves.
+///
+/// @param [in,out] prob Estimation problem.
+/// @param [in,out] x Initial point and minimizer.
+/// @param [in] step Size of the initial simplex.
+/// @param [in] ftol Tolerance on the spread of objective values.
+/// @param [in] maxIter Maximum number of iterations.
+///
+/// @returns Objective value at the minimizer.
+///
+//////////////////////////////////////////////////////////////////////////////
+static REAL nelderMead(smmProblem& prob, VectorXR& x, const REAL& step,
+		       const REAL& ftol, const int& maxIter)
+{
+  const int n = x.size();
+  MatrixXR S(n, n+1);
+  VectorXR f;
+  S.col(0) = x;
+  for(int ix = 0 ; ix < n ; ++ix){
+    S.col(ix+1) = x;
+    S(ix,ix+1) += step;
+  }
+  smmObjective(prob, S, f);
+
+  MatrixXR trial(n, 4);
+  VectorXR ft;
+  vector<int> ord(n+1);
+  for(int iter = 0 ; iter < maxIter ; ++iter){
+
+    // order the vertices
+    for(int ix = 0 ; ix <= n ; ++ix) ord[ix] = ix;
+    for(int ix = 1 ; ix <= n ; ++ix){
+      for(int jx = ix ; jx > 0 && f(ord[jx]) < f(ord[jx-1]) ; --jx){
+	swap(ord[jx], ord[jx-1]);
+      }
+    }
+    const int best = ord[0], worst = ord[n], second = ord[n-1];
+    if(f(worst) - f(best) < ftol) break;
+
+    // reflection, expansion, outside and inside contraction
+    const VectorXR c = (S.rowwise().sum() - S.col(worst))/n;
+    trial.col(0) = c + (c - S.col(worst));
+    trial.col(1) = c + 2*(c - S.col(worst));
+    trial.col(2) = c + 0.5*(c - S.col(worst));
+    trial.col(3) = c - 0.5*(c - S.col(worst));
+    smmObjective(prob, trial, ft);
+
+    if(ft(0) < f(best)){
+      const int e = ft(1) < ft(0) ? 1 : 0;
+      S.col(worst) = trial.col(e); f(worst) = ft(e);
+    } else if(ft(0) < f(second)){
+      S.col(worst) = trial.col(0); f(worst) = ft(0);
+    } else if(ft(0) < f(worst) && ft(2) <= ft(0)){
+      S.col(worst) = trial.col(2); f(worst) = ft(2);
+    } else if(ft(0) >= f(worst) && ft(3) < f(worst)){
+      S.col(worst) = trial.col(3); f(worst) = ft(3);
+    } else {
+      // shrink towards the best vertex
+      MatrixXR shrunk(n, n);
+      for(int ix = 1 ; ix <= n ; ++ix){
+	shrunk.col(ix-1) = S.col(best) + 0.5*(S.col(ord[ix]) - S.col(best));
+      }
+      VectorXR fs;
+      smmObjective(prob, shrunk, fs);
+      for(int ix = 1 ; ix <= n ; ++ix){
+	S.col(ord[ix]) = shrunk.col(ix-1);
+	f(ord[ix]) = fs(ix-1);
+      }
+    }
+  }
+  int best;
+  const REAL fmin = f.minCoeff(&best);
+  x = S.col(best);
+  return fmin;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @fn main()
+///
+/// @brief Main function for simulated method of moments estimation.
+///
+/// @details This function estimates (beta, rho, sigma, eta) by matching
+/// simulated moments to targets (see @link loadTargets @endlink), starting
+/// from the values in `../parameters.txt', which also supplies the other
+/// parameters. The model is solved in-process with one @link Solver
+/// @endlink per point of a batch of candidates, warm started from the
+/// candidate at the same position in the previous batch, and the objective
+/// is minimized with a parallel Nelder-Mead search (see @link nelderMead
+/// @endlink). The estimates do not depend on the number of threads.
+///
+/// @details Usage: `./estimate targets'. The estimates, the objective
+/// value, the number of objective evaluations and the mean time per
+/// evaluation (wall time of each parallel batch divided by its size) are
+/// written to `estimateCPP.dat'.
+///
+/// @returns 0 upon successful completion, 1 otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+  if(argc < 2){
+    cerr << "Usage: " << argv[0] << " targets" << endl;
+    return 1;
+  }
+
+  // Load parameters and targets
+  smmProblem prob;
+  prob.base.load("../parameters.txt");
+  if(!loadTargets(argv[1], prob)){
+    cerr << "Could not read moment targets " << argv[1] << endl;
+    return 1;
+  }
+  prob.nEval = 0;
+  prob.evalTime = 0.0;
+  prob.solvers.assign(nTheta+1, Solver(prob.base));
+
+  // estimate
+  double tic = curr_second();
+  VectorXR x = toCoord(prob.base);
+  const REAL fmin = nelderMead(prob, x, 0.1, 1e-8, 200);
+  const parameters est = toParam(prob.base, x);
+  double totalTime = curr_second() - tic;
+
+  // write to file
+  ofstream fileEst;
+  fileEst.precision(10);
+  fileEst.open("estimateCPP.dat");
+  fileEst << est.beta << endl;
+  fileEst << est.rho << endl;
+  fileEst << est.sigma << endl;
+  fileEst << est.eta << endl;
+  fileEst << fmin << endl;
+  fileEst << prob.nEval << endl;
+  fileEst << prob.evalTime/prob.nEval << endl;
+  fileEst << totalTime << endl;
+  fileEst.close();
+  cout << "beta = " << est.beta << ", rho = " << est.rho << ", sigma = "
+       << est.sigma << ", eta = " << est.eta << ", objective = " << fmin
+       << endl << prob.nEval << " evaluations, " << prob.evalTime/prob.nEval
+       << " seconds per evaluation" << endl;
+
+  return 0;
+}
@@ -0,0 +1,152 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file eulerErr.cpp
+///
+/// @brief File containing function to compute Euler equation errors of the
+/// VFI solution.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute the Euler error at a single state.
+///
+/// @details The error is log10|1 - c~/c|, where c is consumption implied
+/// by the policy and c~ is the consumption that sets the Euler equation to
+/// equality given next period's consumption under the policy. States where
+/// consumption is nonpositive are flagged by returning a positive value.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] k Current level of capital.
+/// @param [in] j Index of current TFP value.
+/// @param [in] kp Future capital chosen at (k, Z(j)).
+/// @param [in] K Grid of capital values.
+/// @param [in] Z Grid of TFP values.
+/// @param [in] P TFP transition matrix.
+/// @param [in] lo First column of the band of P.row(j) (see @link pBand
+/// @endlink).
+/// @param [in] len Width of the band of P.row(j).
+/// @param [in] G Matrix storing policy function.
+/// @param [in] onGrid Whether kp lies on the capital grid at index gx.
+/// @param [in] gx Index of kp in K (used only when onGrid is true).
+///
+/// @returns log10 Euler equation error.
+///
+//////////////////////////////////////////////////////////////////////////////
+static REAL eulerPoint(const parameters& param, const REAL& k, const int& j,
+		       const REAL& kp, const VectorXR& K, const VectorXR& Z,
+		       const MatrixXR& P, const int& lo, const int& len,
+		       const MatrixXi& G, const bool onGrid, const int gx)
+{
+  const REAL eta = param.eta;
+  const REAL beta = param.beta;
+  const REAL alpha = param.alpha;
+  const REAL delta = param.delta;
+
+  const REAL c = Z(j)*pow(k,alpha) + (1-delta)*k - kp;
+  if(c <= 0) return 1.0;
+
+  // expected marginal utility times gross return on capital
+  REAL kpp, cp, rhs = 0.0;
+  const REAL mpk = alpha*pow(kp,alpha-1);
+  for(int l = lo ; l < lo+len ; ++l){
+    kpp = onGrid ? K(G(gx,l)) : polInterp(kp, l, K, G);
+    cp = Z(l)*pow(kp,alpha) + (1-delta)*kp - kpp;
+    if(cp <= 0) return 1.0;
+    rhs += P(j,l)*pow(cp,-eta)*(Z(l)*mpk + 1 - delta);
+  }
+  const REAL err = fabs(1 - pow(beta*rhs,-1/eta)/c);
+  return log10(err > 1e-17 ? err : 1e-17);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute Euler equation errors of the VFI solution.
+///
+/// @details This function computes log10 Euler equation errors of the
+/// policy function, both at every point of the state space grid and at a
+/// dense, equally spaced set of capital values which lie off of the grid.
+/// Off the grid, the policy is evaluated by linear interpolation via
+/// @link polInterp @endlink. The states are evaluated in parallel with
+/// OpenMP. Expectations use the same banded transition matrix as @link
+/// vfStep @endlink.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] K Grid of capital values.
+/// @param [in] Z Grid of TFP values.
+/// @param [in] P TFP transition matrix.
+/// @param [in] G Matrix storing policy function.
+/// @param [in] nTest Number of capital values in the off-grid test set.
+/// @param [out] stats Maximum and mean errors on and off the grid.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void eulerErr(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	      const MatrixXR& P, const MatrixXi& G, const int& nTest,
+	      eulerStats& stats)
+{
+  const int nk = param.nk;
+  const int nz = param.nz;
+
+  // banded approximation of the transition matrix, as in vfStep
+  MatrixXR Pt;
+  VectorXi plo, plen;
+  pBand(P, param.pTol, Pt, plo, plen);
+
+  // errors at the grid points
+  REAL err, maxErr = -HUGE_VAL, sumErr = 0.0;
+  int nBad = 0;
+#pragma omp parallel for collapse(2) private(err) reduction(max:maxErr) reduction(+:sumErr,nBad)
+  for(int j = 0 ; j < nz ; ++j){
+    for(int i = 0 ; i < nk ; ++i){
+      err = eulerPoint(param, K(i), j, K(G(i,j)), K, Z, Pt, plo(j), plen(j), G,
+		       true, G(i,j));
+      if(err > 0){++nBad; continue;}
+      if(err > maxErr) maxErr = err;
+      sumErr += err;
+    }
+  }
+  stats.maxGrid = maxErr;
+  stats.meanGrid = sumErr/(nk*nz-nBad);
+  stats.nBad = nBad;
+
+  // errors at the off-grid test points
+  const REAL kstep = (K(nk-1)-K(0))/(nTest-1);
+  REAL k;
+  maxErr = -HUGE_VAL;
+  sumErr = 0.0;
+  nBad = 0;
+#pragma omp parallel for collapse(2) private(err,k) reduction(max:maxErr) reduction(+:sumErr,nBad)
+  for(int j = 0 ; j < nz ; ++j){
+    for(int t = 0 ; t < nTest ; ++t){
+      k = K(0) + t*kstep;
+      err = eulerPoint(param, k, j, polInterp(k, j, K, G), K, Z, Pt, plo(j),
+		       plen(j), G, false, 0);
+      if(err > 0){++nBad; continue;}
+      if(err > maxErr) maxErr = err;
+      sumErr += err;
+    }
+  }
+  stats.maxTest = maxErr;
+  stats.meanTest = sumErr/(nTest*nz-nBad);
+  stats.nBad += nBad;
+}
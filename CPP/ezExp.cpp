@@ -0,0 +1,76 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file ezExp.cpp
+///
+/// @brief File containing function to compute certainty equivalents under
+/// Epstein-Zin preferences.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute certainty equivalents under Epstein-Zin
+/// preferences.
+///
+/// @details Under Epstein-Zin preferences with risk aversion gamma and
+/// intertemporal elasticity of substitution 1/eta, utility U satisfies
+///
+///   U = [c^(1-eta) + beta*CE^(1-eta)]^(1/(1-eta)),
+///   CE = (E[U'^(1-gamma)])^(1/(1-gamma)),
+///
+/// and the solver iterates on v = U^(1-eta)/(1-eta), for which
+/// v = c^(1-eta)/(1-eta) + beta*X with X = CE^(1-eta)/(1-eta). This is the
+/// CRRA Bellman equation with X in place of the expected continuation
+/// value, so that @link binaryMax @endlink applies unchanged. This function
+/// computes X for all future capital values and current TFP states at
+/// once: the transform ((1-eta)*v)^((1-gamma)/(1-eta)) = U^(1-gamma) is
+/// applied to V0, the result is multiplied by P', and the inverse
+/// transform is applied to the product. If gamma = 1 the certainty
+/// equivalent is exp(E[log U']) and the transform is a logarithm. If
+/// gamma = eta, X equals the CRRA expectation up to rounding.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] P TFP transition matrix (possibly banded, see @link pBand
+/// @endlink).
+/// @param [in] V0 Value function in units of v (rows over future capital,
+/// columns over future TFP).
+/// @param [out] X Transformed certainty equivalents (rows over future
+/// capital, columns over current TFP).
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void ezExp(const parameters& param, const MatrixXR& P,
+	   const Ref<const MatrixXR>& V0, MatrixXR& X)
+{
+  const REAL eta = param.eta;
+  const REAL gamma = param.gamma;
+  MatrixXR M;
+  if(gamma == 1){
+    M = ((1-eta)*V0.array()).log().matrix()/(1-eta);
+    X.noalias() = M*P.transpose();
+    X = X.array().exp().pow(1-eta)/(1-eta);
+  } else {
+    const REAL a = (1-gamma)/(1-eta);
+    M = ((1-eta)*V0.array()).pow(a).matrix();
+    X.noalias() = M*P.transpose();
+    X = X.array().pow(1/a)/(1-eta);
+  }
+}
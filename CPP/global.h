@@ -22,6 +22,9 @@
 #define __FILE_GLOBALVARS_H_SEEN__
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <string>
+#include <vector>
 
 using namespace Eigen;
 
@@ -31,6 +34,19 @@ typedef Eigen::Matrix<REAL, 1, Eigen::Dynamic> RowVectorXR;
 typedef Eigen::Matrix<REAL, Eigen::Dynamic, Eigen::Dynamic> MatrixXR;
 typedef Eigen::Array<REAL, Eigen::Dynamic, 1> ArrayXR;
 typedef Eigen::Array<REAL, Eigen::Dynamic, Eigen::Dynamic> ArrayXXR;
+typedef Eigen::SparseMatrix<REAL, Eigen::RowMajor> SpMatR;
+
+/// Progress callback for value function iteration: receives the iteration
+/// count, the current sup-norm difference and user data; returning nonzero
+/// stops the iteration.
+typedef int (*vfProgress)(int iter, REAL diff, void* data);
+
+/// Methods of discretizing the AR1 TFP process.
+enum zMethods {
+  zTauchen, ///< Tauchen (1986).
+  zTauchenHussey, ///< Tauchen and Hussey (1991) Gauss-Hermite quadrature.
+  zRouwenhorst ///< Rouwenhorst (1995), as in Kopecky and Suen (2010).
+};
 
 //////////////////////////////////////////////////////////////////////////////
 ///
@@ -52,19 +68,194 @@ class parameters{
   int nk; ///< Number of values in capital grid.
   int nz; ///< Number of values in TFP grid.
   REAL tol; ///< Tolerance for convergence.
+  int zMethod; ///< Discretization of TFP (see zMethods).
+  REAL pTol; ///< Truncation tolerance for TFP transition probabilities (see pBand).
+  REAL gamma; ///< Epstein-Zin risk aversion (0 for CRRA utility, see ezExp).
+  int guard; ///< Nonzero to guard the maximization against nonconcavity (see binaryMaxGuard).
+  parameters() : zMethod(zTauchen), pTol(1e-14), gamma(0), guard(0) {}
   void load(const char*);
+  bool set(const std::string&, const REAL&);
+};
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @class eulerStats
+///
+/// @brief Object to store summary statistics of log10 Euler equation errors.
+///
+//////////////////////////////////////////////////////////////////////////////
+class eulerStats{
+ public:
+  REAL maxGrid; ///< Maximum error at the grid points.
+  REAL meanGrid; ///< Mean error at the grid points.
+  REAL maxTest; ///< Maximum error at the off-grid test points.
+  REAL meanTest; ///< Mean error at the off-grid test points.
+  int nBad; ///< Number of states with nonpositive consumption (excluded).
+};
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @class simStats
+///
+/// @brief Object to store moments of simulated economies.
+///
+//////////////////////////////////////////////////////////////////////////////
+class simStats{
+ public:
+  REAL meanK; ///< Mean of capital.
+  REAL sdK; ///< Standard deviation of capital.
+  REAL meanY; ///< Mean of output.
+  REAL sdY; ///< Standard deviation of output.
+  REAL meanC; ///< Mean of consumption.
+  REAL sdC; ///< Standard deviation of consumption.
+  REAL meanI; ///< Mean of investment.
+  REAL sdI; ///< Standard deviation of investment.
+  REAL acY; ///< First order autocorrelation of output.
+};
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @class polHist
+///
+/// @brief Object to store the policy functions of all ages in a finite
+/// horizon problem.
+///
+/// @details The capital indices of each column are divided into blocks of
+/// 2^shift values. Each block stores the smallest policy index in the block
+/// as an int, and each policy index is stored as a 16-bit offset from it.
+/// Since the policy is nondecreasing in capital, the offsets within a block
+/// are small, and any policy index is found with two loads.
+///
+//////////////////////////////////////////////////////////////////////////////
+class polHist{
+ public:
+  static const int shift = 5; ///< Log2 of the number of indices per block.
+  int nk; ///< Number of values in capital grid.
+  int nz; ///< Number of values in TFP grid.
+  int nAge; ///< Number of ages.
+  int nBlock; ///< Number of blocks per column.
+  std::vector<int> base; ///< Smallest policy index of each block.
+  std::vector<unsigned short> off; ///< Offset of each policy index from its base.
+  void init(const int&, const int&, const int&);
+  bool store(const int&, const MatrixXi&);
+  /// Policy index at capital index i, TFP index j and age t.
+  int operator()(const int& i, const int& j, const int& t) const {
+    const size_t col = j + (size_t)nz*t;
+    return base[(i >> shift) + nBlock*col] + off[i + nk*col];
+  }
+};
+
+/// Backing of a buffer allocated by hugeAlloc.
+enum hugeKind {
+  hugeExplicit, ///< Explicit huge pages (MAP_HUGETLB).
+  hugeTransparent, ///< 2 MB aligned mapping advised for transparent huge pages.
+  hugeNone, ///< 2 MB aligned mapping with base pages.
+  hugeHeap ///< 64-byte aligned heap allocation.
 };
 
 // Function declarations
 double curr_second (void);
 void ar1(const parameters& param, VectorXR& Z, MatrixXR& P);
+REAL pBand(const MatrixXR& P, const REAL& tol, MatrixXR& Pt, VectorXi& lo,
+	   VectorXi& len);
 void kGrid(const parameters& param, const VectorXR& Z, VectorXR& K);
-void vfInit(const parameters& param, const VectorXR& Z, MatrixXR& V);
-void vfStep(const parameters& param, const VectorXR& K, const VectorXR& Z,
-	    const MatrixXR& P, const MatrixXR& V0, MatrixXR& V, MatrixXi& G);
+void vfInit(const parameters& param, const VectorXR& Z, Ref<MatrixXR> V);
+int vfSolve(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	    const MatrixXR& P, Ref<MatrixXR> V0, Ref<MatrixXR> V,
+	    Ref<MatrixXi> G,
+	    vfProgress progress = NULL, void* data = NULL);
+int vfSolveWarm(const parameters& param, const VectorXR& K, const VectorXR& Z,
+		const MatrixXR& P, const REAL& betaSrc, const VectorXR& Ksrc,
+		const VectorXR& Zsrc, const Ref<const MatrixXR>& Vsrc,
+		MatrixXR& V0, Ref<MatrixXR> V, Ref<MatrixXi> G,
+		vfProgress progress = NULL, void* data = NULL);
+void vfWarm(const VectorXR& Ksrc, const VectorXR& Zsrc,
+	    const Ref<const MatrixXR>& Vsrc,
+	    const REAL& scale, const VectorXR& K, const VectorXR& Z,
+	    MatrixXR& V0);
+bool vfBackward(const parameters& param, const VectorXR& K,
+		const VectorXR& Z, const MatrixXR& P, const int& T, MatrixXR& V,
+		polHist& H);
+int vfStep(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	   const MatrixXR& P, const Ref<const MatrixXR>& V0, Ref<MatrixXR> V,
+	   Ref<MatrixXi> G);
+void vfStep2(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	     const VectorXR& Q, const MatrixXR& P1, const MatrixXR& P2,
+	     const MatrixXR& V0, MatrixXR& V, MatrixXi& G);
+void kronExp(const MatrixXR& V0, const MatrixXR& P1, const MatrixXR& P2,
+	     MatrixXR& EV);
+void vfStepCash(const parameters& param, const VectorXR& A,
+		const MatrixXR& cash, const MatrixXR& P, const MatrixXR& V0,
+		MatrixXR& V, MatrixXi& G);
+int transPath(const parameters& param, const VectorXR& A, const VectorXR& E,
+	      const MatrixXR& P, const VectorXR& Zt, const MatrixXR& Vss,
+	      const VectorXR& mu0, const REAL& tol, const int& maxIter,
+	      VectorXR& Kt, REAL& diff);
+void vfStepKS(const parameters& param, const VectorXR& A, const VectorXR& Kb,
+	      const VectorXR& Z, const VectorXR& E, const MatrixXR& Pz,
+	      const MatrixXR& Pe, const MatrixXR& B, const MatrixXR& V0,
+	      MatrixXR& V, MatrixXi& G);
+void vfStepDef(const parameters& param, const REAL& r, const REAL& theta,
+	       const VectorXR& B, const VectorXR& Y, const VectorXR& Yd,
+	       const MatrixXR& P, const int& i0, const MatrixXR& V0,
+	       const VectorXR& Vd0, const MatrixXR& D0, MatrixXR& V,
+	       VectorXR& Vd, MatrixXR& D, MatrixXR& q, MatrixXi& G);
+void vfStepTab(const parameters& param, const MatrixXR& P, const MatrixXR& U,
+	       const MatrixXi& klo, const MatrixXi& khi, const MatrixXR& V0,
+	       MatrixXR& V, MatrixXi& G);
+int laborTab(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	     const MatrixXR& P, const REAL& frisch, const REAL& psi,
+	     const MatrixXR& V0, const MatrixXi& G, MatrixXR& U,
+	     MatrixXi& klo, MatrixXi& khi);
+REAL staticLabor(const REAL& A, const REAL& B, const REAL& alpha,
+		 const REAL& eta, const REAL& frisch, const REAL& psi, REAL& x);
+void ezExp(const parameters& param, const MatrixXR& P,
+	   const Ref<const MatrixXR>& V0, MatrixXR& X);
 int binaryVal(const REAL& x, const VectorXR& X);
 void binaryMax(const int& klo, const int& nksub, const REAL& ydepK,
 	       const REAL eta, const REAL beta, const VectorXR& K,
-	       const VectorXR& Exp, REAL& V, int& G);
+	       const Ref<const VectorXR>& Exp, REAL& V, int& G);
+bool binaryMaxGuard(const int& klo, const int& nksub, const REAL& ydepK,
+		    const REAL eta, const REAL beta, const VectorXR& K,
+		    const Ref<const VectorXR>& Exp, REAL& V, int& G);
+void gridMax(const int& klo, const int& nksub, const REAL& ydepK,
+	     const REAL eta, const REAL beta, const Ref<const VectorXR>& K,
+	     const Ref<const VectorXR>& Exp, REAL& V, int& G);
+REAL polInterp(const REAL& k, const int& j, const VectorXR& K,
+	       const MatrixXi& G);
+void eulerErr(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	      const MatrixXR& P, const MatrixXi& G, const int& nTest,
+	      eulerStats& stats);
+REAL cbrng(const unsigned long long& seed, const unsigned long long& stream,
+	   const unsigned long long& ctr);
+int zDraw(const REAL& u, const int& j, const MatrixXR& Pc);
+void simulate(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	      const MatrixXR& P, const MatrixXi& G, const int& nAgents,
+	      const int& nPeriods, const int& nBurn,
+	      const unsigned long long& seed, const bool& interp,
+	      simStats& stats);
+void spMV(const SpMatR& A, const VectorXR& x, VectorXR& y);
+void transOp(const parameters& param, const VectorXR& K, const MatrixXR& P,
+	     const MatrixXR& Kp, SpMatR& T);
+int statDist(const SpMatR& T, const int& mAnderson, const REAL& tol,
+	     const int& maxIter, VectorXR& mu);
+void writeBin(const char* fileName, const MatrixXR& X);
+unsigned long long solHash(const parameters& param);
+bool cacheLoad(const char* dir, const parameters& param, Ref<MatrixXR> V,
+	       Ref<MatrixXi> G);
+bool cacheStore(const char* dir, const parameters& param,
+		const Ref<const MatrixXR>& V, const Ref<const MatrixXi>& G,
+		const size_t& budget);
+void irf(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	 const MatrixXR& Kp, const SpMatR& T, const VectorXR& mu,
+	 const int& nT, MatrixXR& R);
+int cpuList(const std::string& list, VectorXi& cpus);
+int numaNodes(VectorXi& cpuNode);
+bool pinThreads(const std::string& spec, MatrixXi& map);
+bool numaInterleave();
+void numaBandwidth(const Ref<const MatrixXR>& X, const int& nRep,
+		   VectorXR& bw);
+void* hugeAlloc(const size_t& bytes, int& kind);
+void hugeFree(void* ptr, const size_t& bytes, const int& kind);
 
 #endif
@@ -0,0 +1,67 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file gridMax.cpp
+///
+/// @brief File containing function to compute maximum of Bellman objective
+/// via grid search.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute maximum of Bellman objective via grid search.
+///
+/// @details This function finds the maximum and argmax of the Bellman
+/// objective (ydepK-K(k))^(1-eta)/(1-eta) + beta*Exp(k-klo) over the
+/// subgrid k = klo,...,klo+nksub-1 by evaluating it at every point, as in
+/// @link binaryMax @endlink but without assuming concavity, so that it
+/// applies when the objective has several local maxima. K need not be
+/// monotonic: it is the cost of each choice, and choices with nonpositive
+/// consumption are skipped. If no choice is feasible, V is -HUGE_VAL and G
+/// is klo.
+///
+/// @param [in] klo Lower index of the grid to begin search.
+/// @param [in] nksub Number of points in the grid to include in search.
+/// @param [in] ydepK Resources available for consumption and choice.
+/// @param [in] eta Coefficient of relative risk aversion.
+/// @param [in] beta Time discount factor.
+/// @param [in] K Cost of each choice (e.g. grid of capital values).
+/// @param [in] Exp Expected value function continuation values.
+/// @param [out] V Updated value function.
+/// @param [out] G Updated policy function.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void gridMax(const int& klo, const int& nksub, const REAL& ydepK,
+	     const REAL eta, const REAL beta, const Ref<const VectorXR>& K,
+	     const Ref<const VectorXR>& Exp, REAL& V, int& G)
+{
+  REAL c, w;
+  V = -HUGE_VAL;
+  G = klo;
+  for(int ks = 0 ; ks < nksub ; ++ks){
+    c = ydepK - K(klo+ks);
+    if(c <= 0) continue;
+    w = pow(c,1-eta)/(1-eta) + beta*Exp(ks);
+    if(w > V){V = w; G = klo+ks;}
+  }
+}
@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file hugeAlloc.cpp
+///
+/// @brief File containing functions to allocate buffers backed by huge
+/// pages.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <string>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+using namespace std;
+
+/// Size of a huge page (2 MB).
+static const size_t hugeSize = (size_t)1 << 21;
+
+/// Alignment of buffers which are not backed by huge pages (a cache line).
+static const size_t lineSize = 64;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to allocate a buffer backed by huge pages.
+///
+/// @details This function first requests explicit 2 MB huge pages
+/// (MAP_HUGETLB, which requires pages reserved in
+/// /proc/sys/vm/nr_hugepages). If none are available, it maps a 2 MB
+/// aligned anonymous region and advises the kernel to back it with
+/// transparent huge pages (MADV_HUGEPAGE). If mapping fails altogether, it
+/// falls back to a 64-byte aligned heap allocation. The environment
+/// variable VFI_HUGEPAGES restricts the choice: `transparent' skips
+/// explicit pages and `off' requests base pages only (MADV_NOHUGEPAGE).
+/// Pages are not touched, so that they are placed by the threads which
+/// first write to them; a huge page is placed whole, on the node of the
+/// first thread to touch any part of it.
+///
+/// @param [in] bytes Size of the buffer in bytes.
+/// @param [out] kind Backing of the buffer (hugeExplicit, hugeTransparent
+/// or hugeNone), to be passed to @link hugeFree @endlink.
+///
+/// @returns Pointer to the buffer (aligned to at least 64 bytes), or NULL
+/// if allocation failed.
+///
+//////////////////////////////////////////////////////////////////////////////
+void* hugeAlloc(const size_t& bytes, int& kind)
+{
+  const char* env = getenv("VFI_HUGEPAGES");
+  const string mode = env != NULL ? env : "";
+  const size_t size = (bytes+hugeSize-1)/hugeSize*hugeSize;
+
+  // explicit huge pages
+  void* ptr;
+  if(mode != "off" && mode != "transparent"){
+    ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+	       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if(ptr != MAP_FAILED){
+      kind = hugeExplicit;
+      return ptr;
+    }
+  }
+
+  // 2 MB aligned region for transparent huge pages: over-allocate and trim
+  ptr = mmap(NULL, size+hugeSize, PROT_READ | PROT_WRITE,
+	     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if(ptr != MAP_FAILED){
+    const uintptr_t base = (uintptr_t)ptr;
+    const uintptr_t start = (base+hugeSize-1)/hugeSize*hugeSize;
+    if(start > base) munmap(ptr, start-base);
+    munmap((void*)(start+size), base+hugeSize-start);
+    ptr = (void*)start;
+    if(mode != "off" && madvise(ptr, size, MADV_HUGEPAGE) == 0){
+      kind = hugeTransparent;
+    } else {
+      if(mode == "off") madvise(ptr, size, MADV_NOHUGEPAGE);
+      kind = hugeNone;
+    }
+    return ptr;
+  }
+
+  // aligned heap allocation
+  kind = hugeHeap;
+  if(posix_memalign(&ptr, lineSize, bytes > 0 ? bytes : lineSize) != 0) return NULL;
+  return ptr;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to free a buffer allocated by @link hugeAlloc @endlink.
+///
+/// @param [in] ptr Pointer to the buffer.
+/// @param [in] bytes Size of the buffer in bytes, as passed to hugeAlloc.
+/// @param [in] kind Backing of the buffer, as returned by hugeAlloc.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void hugeFree(void* ptr, const size_t& bytes, const int& kind)
+{
+  if(ptr == NULL) return;
+  if(kind == hugeHeap) free(ptr);
+  else munmap(ptr, (bytes+hugeSize-1)/hugeSize*hugeSize);
+}
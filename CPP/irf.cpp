@@ -0,0 +1,110 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file irf.cpp
+///
+/// @brief File containing function to compute impulse responses to a TFP
+/// shock.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute impulse responses to a TFP shock.
+///
+/// @details This function computes the responses of aggregate TFP,
+/// capital, output, consumption and investment to a one standard deviation
+/// innovation to log TFP, starting from the stationary distribution mu. On
+/// impact, the TFP component of each state is shifted up by sigma in logs,
+/// with mass split between the two bracketing points of the TFP grid by
+/// linear interpolation in log TFP (mass beyond the top of the grid remains
+/// at the top), so that grids which are not equally spaced in logs (e.g.
+/// Tauchen-Hussey) are handled. The shocked distribution
+/// is then pushed forward through the transition operator T with the
+/// parallel sparse product @link spMV @endlink, so that subsequent TFP
+/// paths follow P conditional on the shock. Responses are reported as
+/// percent deviations from the stationary aggregates.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] K Grid of capital values.
+/// @param [in] Z Grid of TFP values.
+/// @param [in] Kp Matrix storing future capital values of the policy.
+/// @param [in] T Sparse transition operator, as built by @link transOp
+/// @endlink.
+/// @param [in] mu Stationary distribution, as computed by @link statDist
+/// @endlink.
+/// @param [in] nT Number of periods of the response.
+/// @param [out] R nT x 5 matrix of responses of TFP, capital, output,
+/// consumption and investment (by column).
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void irf(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	 const MatrixXR& Kp, const SpMatR& T, const VectorXR& mu,
+	 const int& nT, MatrixXR& R)
+{
+
+  // basic parameters
+  const int nk = param.nk;
+  const int nz = param.nz;
+  const REAL alpha = param.alpha;
+  const REAL delta = param.delta;
+  const REAL sigma = param.sigma;
+
+  // aggregated variables at each state (column major)
+  MatrixXR X(nk*nz, 5);
+  for(int j = 0 ; j < nz ; ++j){
+    X.block(j*nk, 0, nk, 1).setConstant(Z(j));
+    X.block(j*nk, 1, nk, 1) = K;
+    X.block(j*nk, 2, nk, 1) = Z(j)*K.array().pow(alpha).matrix();
+    X.block(j*nk, 4, nk, 1) = Kp.col(j) - (1-delta)*K;
+    X.block(j*nk, 3, nk, 1) = X.block(j*nk, 2, nk, 1) - X.block(j*nk, 4, nk, 1);
+  }
+  const RowVectorXR Xss = mu.transpose()*X;
+
+  // shift the TFP component of the distribution by one standard deviation
+  const VectorXR logZ = Z.array().log().matrix();
+  VectorXR mut = VectorXR::Zero(nk*nz);
+  int jlo, jhi;
+  REAL zs, w;
+  for(int j = 0 ; j < nz ; ++j){
+    zs = logZ(j) + sigma;
+    if(zs >= logZ(nz-1)){
+      jlo = nz-1; jhi = nz-1; w = 1.0;
+    } else {
+      jhi = binaryVal(zs, logZ);
+      jlo = jhi-1;
+      w = (zs-logZ(jlo))/(logZ(jhi)-logZ(jlo));
+    }
+    mut.segment(jlo*nk, nk) += (1-w)*mu.segment(j*nk, nk);
+    mut.segment(jhi*nk, nk) += w*mu.segment(j*nk, nk);
+  }
+
+  // push the shocked distribution forward through the policy
+  VectorXR mun(nk*nz);
+  R.resize(nT, 5);
+  for(int t = 0 ; t < nT ; ++t){
+    R.row(t) = 100*((mut.transpose()*X).array()/Xss.array() - 1).matrix();
+    spMV(T, mut, mun);
+    mut.swap(mun);
+  }
+}
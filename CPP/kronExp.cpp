@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file kronExp.cpp
+///
+/// @brief File containing function to compute expectations over two
+/// independent shocks.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute expectations over two independent shocks.
+///
+/// @details The shock state j = j1 + n1*j2 combines the states of two
+/// independent Markov chains with transition matrices P1 (n1 x n1) and P2
+/// (n2 x n2), so that the joint transition matrix is the Kronecker product
+/// P2 x P1. This function computes EV = V0*(P2 x P1)' without forming the
+/// product, as two contractions: first over the first shock, with a
+/// product of each nk x n1 block of columns of V0 by P1', and then over
+/// the second shock, with a product of the result (viewed as an nk*n1 x n2
+/// matrix) by P2'. The cost per state is O(n1+n2) rather than O(n1*n2).
+///
+/// @param [in] V0 Value function (nk x n1*n2).
+/// @param [in] P1 Transition matrix of the first shock.
+/// @param [in] P2 Transition matrix of the second shock.
+/// @param [out] EV Expected continuation values (nk x n1*n2).
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void kronExp(const MatrixXR& V0, const MatrixXR& P1, const MatrixXR& P2,
+	     MatrixXR& EV)
+{
+  const int nk = V0.rows();
+  const int n1 = P1.rows();
+  const int n2 = P2.rows();
+
+  // contraction over the first shock
+  MatrixXR W(nk, n1*n2);
+  for(int l2 = 0 ; l2 < n2 ; ++l2){
+    W.middleCols(l2*n1, n1).noalias() = V0.middleCols(l2*n1, n1)*P1.transpose();
+  }
+
+  // contraction over the second shock
+  EV.resize(nk, n1*n2);
+  Map<MatrixXR>(EV.data(), nk*n1, n2).noalias() =
+    Map<const MatrixXR>(W.data(), nk*n1, n2)*P2.transpose();
+}
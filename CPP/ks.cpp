@@ -0,0 +1,269 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file ks.cpp
+///
+/// @brief File containing main function for the Krusell-Smith model.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+
+using namespace std;
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to simulate a panel of households in the Krusell-Smith
+/// model.
+///
+/// @details This function simulates nAgents households for nT periods,
+/// starting with capital k0 and the middle labor efficiency. The TFP path
+/// is drawn from stream nAgents of @link cbrng @endlink and labor
+/// efficiency from one stream per household, so that every call with the
+/// same seed uses the same shocks. In each period aggregate capital is the
+/// mean of household capital (summed in a fixed order), and households
+/// follow the policy interpolated linearly in their own capital (see @link
+/// polInterp @endlink) and in aggregate capital. Households are updated in
+/// parallel.
+///
+/// @param [in] A Grid of household capital values.
+/// @param [in] Kb Grid of aggregate capital values.
+/// @param [in] Pz TFP transition matrix.
+/// @param [in] Pe Labor efficiency transition matrix.
+/// @param [in] G Policy function (see @link vfStepKS @endlink).
+/// @param [in] k0 Initial household capital.
+/// @param [in] nAgents Number of households.
+/// @param [in] nT Number of periods.
+/// @param [in] seed Seed of the random number generator.
+/// @param [out] Kpath Aggregate capital in each period.
+/// @param [out] zPath TFP index in each period.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+static void ksPanel(const VectorXR& A, const VectorXR& Kb, const MatrixXR& Pz,
+		    const MatrixXR& Pe, const MatrixXi& G, const REAL& k0,
+		    const int& nAgents, const int& nT,
+		    const unsigned long long& seed, VectorXR& Kpath,
+		    VectorXi& zPath)
+{
+  const int nz = Pz.rows();
+  const int nE = Pe.rows();
+  const int nJ = nz*nE;
+  MatrixXR Pzc(nz, nz), Pec(nE, nE);
+  Pzc.col(0) = Pz.col(0);
+  for(int l = 1 ; l < nz ; ++l) Pzc.col(l) = Pzc.col(l-1) + Pz.col(l);
+  Pec.col(0) = Pe.col(0);
+  for(int l = 1 ; l < nE ; ++l) Pec.col(l) = Pec.col(l-1) + Pe.col(l);
+
+  VectorXR k = VectorXR::Constant(nAgents, k0);
+  VectorXi e = VectorXi::Constant(nAgents, nE/2);
+  Kpath.resize(nT);
+  zPath.resize(nT);
+  int jz = nz/2;
+  for(int t = 0 ; t < nT ; ++t){
+    const REAL Kt = k.sum()/nAgents;
+    Kpath(t) = Kt;
+    zPath(t) = jz;
+
+    // bracket of aggregate capital
+    int mhi = binaryVal(Kt, Kb);
+    if(mhi == 0) mhi = 1;
+    const int mlo = mhi-1;
+    const REAL w = (Kt-Kb(mlo))/(Kb(mhi)-Kb(mlo));
+
+#pragma omp parallel for schedule(static)
+    for(int a = 0 ; a < nAgents ; ++a){
+      const int j = jz + nz*e(a);
+      k(a) = (1-w)*polInterp(k(a), j + nJ*mlo, A, G) +
+	w*polInterp(k(a), j + nJ*mhi, A, G);
+      e(a) = zDraw(cbrng(seed, a, t), e(a), Pec);
+    }
+    jz = zDraw(cbrng(seed, nAgents, t), jz, Pzc);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @fn main()
+///
+/// @brief Main function for the Krusell-Smith model.
+///
+/// @details This function solves the Krusell and Smith (1998) model with
+/// the technology, preferences and TFP process of `../parameters.txt' and
+/// idiosyncratic labor efficiency whose log is an AR1 with persistence
+/// rhoE and innovation standard deviation sigmaE, discretized with nE
+/// states and normalized to mean one. Households save on a grid of nk
+/// values from zero to 4 times the steady-state capital of the
+/// representative agent model (kRA), and aggregate capital takes 8 values
+/// from 0.8 to 2 times kRA.
+///
+/// @details Starting from the rule Kb' = Kb, each outer iteration solves
+/// the household problem given the forecast rule (see @link vfStepKS
+/// @endlink) to a tolerance of 1e-3 times the last change in the rule
+/// (but no less than tol), starting from the value function of the
+/// previous outer iteration, simulates a panel of nAgents households for
+/// 1100 periods with the same shocks in every iteration (see @link ksPanel
+/// @endlink), and regresses log(Kb') on log(Kb) for each TFP state over the
+/// last 1000 periods. The rule is updated halfway towards the estimates
+/// until they change by less than 1e-3 (50 outer iterations at most):
+/// since the policy is discrete, the estimates are a step function of the
+/// rule and cannot be expected to settle much more tightly. The rule for a
+/// TFP state which the simulation does not visit is kept unchanged.
+///
+/// @details Usage: `./ks [rhoE sigmaE nE nAgents]' (default 0.9 0.2 3
+/// 10000). `ksCPP.dat' holds the number of outer iterations, the solution
+/// time, the mean time per outer iteration and, for each TFP state, the
+/// forecast rule coefficients and R^2; `ksIterCPP.dat' holds one line per
+/// outer iteration (largest change in the coefficients, household
+/// iterations, household solution time and simulation time).
+///
+/// @returns 0 upon successful completion, 1 otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+
+  // admin
+  int j;
+  double tic = curr_second(); // Start time
+
+  // Load parameters
+  parameters params;
+  params.load("../parameters.txt");
+  parameters paramE = params;
+  paramE.mu = 0.0;
+  paramE.rho = argc > 4 ? atof(argv[1]) : 0.9;
+  paramE.sigma = argc > 4 ? atof(argv[2]) : 0.2;
+  paramE.nz = argc > 4 ? atoi(argv[3]) : 3;
+  const int nAgents = argc > 4 ? atoi(argv[4]) : 10000;
+  const int nk = params.nk;
+  const int nz = params.nz;
+  const int nE = paramE.nz;
+  const int nJ = nz*nE;
+  const int nKb = 8;
+  const int nBurn = 100;
+  const int nPeriods = 1000;
+  const int maxOuter = 50;
+  const REAL damp = 0.5;
+  const REAL tolB = 1e-3;
+  const REAL alpha = params.alpha;
+  const REAL beta = params.beta;
+  const REAL delta = params.delta;
+  const REAL eta = params.eta;
+
+  // shocks: TFP, and labor efficiency normalized so that aggregate labor
+  // is one
+  VectorXR Z(nz), E(nE);
+  MatrixXR Pz(nz, nz), Pe(nE, nE);
+  ar1(params, Z, Pz);
+  ar1(paramE, E, Pe);
+  RowVectorXR piE = RowVectorXR::Constant(nE, 1.0/nE);
+  for(int it = 0 ; it < 10000 ; ++it) piE = piE*Pe;
+  E /= piE.dot(E);
+
+  // household and aggregate capital grids
+  const REAL kRA = pow((1/alpha)*((1/beta)-1+delta),1/(alpha-1));
+  const VectorXR A = VectorXR::LinSpaced(nk, 0.0, 4*kRA);
+  const VectorXR Kb = VectorXR::LinSpaced(nKb, 0.8*kRA, 2*kRA);
+
+  // initial value function: consume labor income forever
+  MatrixXR V(nk, nKb*nJ), V1(nk, nKb*nJ);
+  MatrixXi G(nk, nKb*nJ);
+  for(int m = 0 ; m < nKb ; ++m){
+    for(j = 0 ; j < nJ ; ++j){
+      V.col(j + nJ*m).setConstant(pow((1-alpha)*Z(j%nz)*pow(Kb(m),alpha)*E(j/nz),1-eta)/((1-eta)*(1-beta)));
+    }
+  }
+
+  // forecast rule iteration
+  MatrixXR B(nz, 2), Bnew(nz, 2);
+  B.col(0).setZero();
+  B.col(1).setOnes();
+  VectorXR R2(nz), Kpath;
+  VectorXi zPath;
+  MatrixXR hist(maxOuter, 4);
+  int nOuter = 0;
+  REAL dB = 1.0;
+  while(dB > tolB && nOuter < maxOuter){
+
+    // household problem, warm started from the previous rule
+    double ticOuter = curr_second();
+    const REAL tolV = fmax(params.tol, 1e-3*dB);
+    REAL diff = 1.0;
+    int iter = 0;
+    while(fabs(diff) > tolV){
+      vfStepKS(params, A, Kb, Z, E, Pz, Pe, B, V, V1, G);
+      diff = (V1-V).array().abs().maxCoeff();
+      V.swap(V1);
+      ++iter;
+    }
+    double vfTime = curr_second() - ticOuter;
+
+    // panel simulation
+    ticOuter = curr_second();
+    ksPanel(A, Kb, Pz, Pe, G, 1.4*kRA, nAgents, nBurn+nPeriods, 20121023,
+	    Kpath, zPath);
+    double simTime = curr_second() - ticOuter;
+
+    // regression of log(Kb') on log(Kb) for each TFP state
+    for(int jz = 0 ; jz < nz ; ++jz){
+      REAL n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0, syy = 0, x, y;
+      for(int t = nBurn ; t < nBurn+nPeriods-1 ; ++t){
+	if(zPath(t) != jz) continue;
+	x = log(Kpath(t));
+	y = log(Kpath(t+1));
+	n += 1; sx += x; sy += y; sxx += x*x; sxy += x*y; syy += y*y;
+      }
+      const REAL vx = sxx - sx*sx/n, vy = syy - sy*sy/n, cxy = sxy - sx*sy/n;
+      Bnew(jz,1) = n > 2 && vx > 0 ? cxy/vx : B(jz,1);
+      Bnew(jz,0) = n > 2 && vx > 0 ? (sy - Bnew(jz,1)*sx)/n : B(jz,0);
+      R2(jz) = n > 2 && vx > 0 && vy > 0 ? cxy*cxy/(vx*vy) : 0.0;
+    }
+    dB = (Bnew-B).array().abs().maxCoeff();
+    B = damp*Bnew + (1-damp)*B;
+
+    hist(nOuter,0) = dB;
+    hist(nOuter,1) = iter;
+    hist(nOuter,2) = vfTime;
+    hist(nOuter,3) = simTime;
+    ++nOuter;
+  }
+  double solTime = curr_second() - tic;
+
+  // write to file
+  ofstream fileKS, fileIter;
+  fileKS.precision(10);
+  fileIter.precision(10);
+  fileKS.open("ksCPP.dat");
+  fileIter.open("ksIterCPP.dat");
+  fileKS << nOuter << endl;
+  fileKS << solTime << endl;
+  fileKS << solTime/nOuter << endl;
+  for(int jz = 0 ; jz < nz ; ++jz){
+    fileKS << B(jz,0) << " " << B(jz,1) << " " << R2(jz) << endl;
+  }
+  fileIter << hist.topRows(nOuter) << endl;
+  fileKS.close();
+  fileIter.close();
+
+  return 0;
+
+}
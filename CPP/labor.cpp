@@ -0,0 +1,195 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file labor.cpp
+///
+/// @brief File containing main function for the growth model with elastic
+/// labor.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+
+using namespace std;
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @fn main()
+///
+/// @brief Main function for the growth model with elastic labor.
+///
+/// @details This function solves the growth model of `main' with output
+/// z*k^alpha*l^(1-alpha) and period utility c^(1-eta)/(1-eta) -
+/// psi*l^(1+1/frisch)/(1+1/frisch), l in (0,1]. The weight psi is set so
+/// that labor equals lss in the deterministic steady state at the median
+/// TFP level, and the capital grid and initial value function are those of
+/// `main' at that labor. The static utility is tabulated in a band of nb
+/// future capital values around the maximizing future capital (see @link
+/// laborTab @endlink), so that the table holds nb*nk*nz rather than
+/// nk*nk*nz values. After each iteration (see @link vfStepTab @endlink)
+/// the bands of the states whose policy lies on an interior edge of the
+/// band are recentred on the maximum over all future capital and the
+/// iteration is repeated, so that the solution is that of the full table
+/// while the objective is concave in future capital. As the policy
+/// settles, few bands move and an iteration costs about as much as one of
+/// the model with inelastic labor.
+///
+/// @details Usage: `./labor [frisch lss]' (default 1 0.3333). The value,
+/// policy and labor functions are written to `valFunLabCPP.dat',
+/// `polFunLabCPP.dat' and `labFunCPP.dat' in the format of `main', and
+/// `laborCPP.dat' holds the solution time, the number of iterations, the
+/// time to tabulate the initial bands of the static utility, the time of
+/// one iteration with elastic labor (including the recentring of bands)
+/// and with inelastic labor (@link vfStep @endlink) on the same grids, the
+/// ratio of the two, psi, the width nb of the bands and the number of
+/// bands recentred during the iterations.
+///
+/// @returns 0 upon successful completion, 1 otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+
+  // admin
+  int i, j;
+  double tic = curr_second(); // Start time
+
+  // Load parameters
+  parameters params;
+  params.load("../parameters.txt");
+  const REAL frisch = argc > 2 ? atof(argv[1]) : 1.0;
+  const REAL lss = argc > 2 ? atof(argv[2]) : 1.0/3;
+  if(frisch <= 0 || lss <= 0 || lss > 1){
+    cerr << "Usage: ./labor [frisch lss] with frisch > 0 and 0 < lss <= 1" << endl;
+    return 1;
+  }
+  const int nk = params.nk;
+  const int nz = params.nz;
+  const REAL alpha = params.alpha;
+  const REAL beta = params.beta;
+  const REAL delta = params.delta;
+  const REAL eta = params.eta;
+
+  // TFP process
+  VectorXR Z(nz);
+  MatrixXR P(nz, nz);
+  ar1(params, Z, P);
+
+  // psi from the steady state at the median TFP level, where capital and
+  // consumption per unit of labor are as in the inelastic model
+  const REAL zss = Z(nz/2);
+  const REAL kl = pow((1/(alpha*zss))*((1/beta)-1+delta),1/(alpha-1));
+  const REAL cl = zss*pow(kl,alpha) - delta*kl;
+  const REAL psi = pow(lss*cl,-eta)*(1-alpha)*zss*pow(kl,alpha)/pow(lss,1/frisch);
+
+  // capital grid and initial value function at labor lss (scaling TFP by
+  // lss^(1-alpha) scales steady-state capital by lss)
+  VectorXR Zl = Z*pow(lss,1-alpha);
+  VectorXR K(nk);
+  kGrid(params, Zl, K);
+  MatrixXR V0(nk, nz), V(nk, nz);
+  MatrixXi G(nk, nz);
+  vfInit(params, Zl, V0);
+
+  // tabulate static utility around the maximum of the first iteration
+  const int nb = nk < 64 ? nk : 64;
+  double ticTab = curr_second();
+  MatrixXR U(nb, nk*nz);
+  MatrixXi klo = MatrixXi::Constant(nk, nz, -1);
+  MatrixXi khi(nk, nz);
+  laborTab(params, K, Z, P, frisch, psi, V0, G, U, klo, khi);
+  double tabTime = curr_second() - ticTab;
+
+  // iterate, recentring the bands on which the maximum is not interior
+  double ticIter = curr_second();
+  REAL diff = 1.0;
+  int iter = 0;
+  int nRetab, nRecentre = 0;
+  while(fabs(diff) > params.tol){
+    do {
+      vfStepTab(params, P, U, klo, khi, V0, V, G);
+      nRetab = laborTab(params, K, Z, P, frisch, psi, V0, G, U, klo, khi);
+      nRecentre += nRetab;
+    } while(nRetab > 0);
+    diff = (V-V0).array().abs().maxCoeff();
+    V0 = V;
+    ++iter;
+  }
+  double iterTime = (curr_second() - ticIter)/iter;
+  double solTime = curr_second() - tic;
+
+  // labor policy
+  MatrixXR L(nk, nz);
+  REAL x;
+  for(j = 0 ; j < nz ; ++j){
+    for(i = 0 ; i < nk ; ++i){
+      x = 0.0;
+      L(i,j) = staticLabor(Z(j)*pow(K(i),alpha), (1-delta)*K(i)-K(G(i,j)),
+			   alpha, eta, frisch, psi, x);
+    }
+  }
+
+  // cost of an iteration of the inelastic model on the same grids
+  const int nRep = 20;
+  MatrixXR V1(nk, nz);
+  MatrixXi G1(nk, nz);
+  tic = curr_second();
+  for(int rep = 0 ; rep < nRep ; ++rep) vfStep(params, K, Z, P, V, V1, G1);
+  double inelTime = (curr_second() - tic)/nRep;
+
+  // write to file (column major)
+  ofstream fileLabor, fileValue, filePolicy, fileLab;
+  fileValue.precision(10);
+  filePolicy.precision(10);
+  fileLab.precision(10);
+  fileLabor.open("laborCPP.dat");
+  fileValue.open("valFunLabCPP.dat");
+  filePolicy.open("polFunLabCPP.dat");
+  fileLab.open("labFunCPP.dat");
+  fileLabor << solTime << endl;
+  fileLabor << iter << endl;
+  fileLabor << tabTime << endl;
+  fileLabor << iterTime << endl;
+  fileLabor << inelTime << endl;
+  fileLabor << iterTime/inelTime << endl;
+  fileLabor << psi << endl;
+  fileLabor << nb << endl;
+  fileLabor << nRecentre << endl;
+  fileValue << nk << endl;
+  fileValue << nz << endl;
+  filePolicy << nk << endl;
+  filePolicy << nz << endl;
+  fileLab << nk << endl;
+  fileLab << nz << endl;
+  for(j = 0 ; j < nz ; ++j){
+    for(i = 0 ; i < nk ; ++i){
+      fileValue << V(i,j) << endl;
+      filePolicy << G(i,j) << endl;
+      fileLab << L(i,j) << endl;
+    }
+  }
+  fileLabor.close();
+  fileValue.close();
+  filePolicy.close();
+  fileLab.close();
+
+  return 0;
+
+}
@@ -0,0 +1,165 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file laborTab.cpp
+///
+/// @brief File containing function to tabulate static utility with elastic
+/// labor.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute static utility with elastic labor.
+///
+/// @param [in] A Output per unit of labor^(1-alpha), z*k^alpha.
+/// @param [in] B Depreciated capital net of future capital, (1-delta)*k-k'.
+/// @param [in] alpha Capital share.
+/// @param [in] eta Coefficient of relative risk aversion.
+/// @param [in] frisch Frisch elasticity of labor supply.
+/// @param [in] psi Weight of the disutility of labor.
+/// @param [in,out] x Starting value for log labor; the solution on output.
+///
+/// @returns Period utility at the optimal labor.
+///
+//////////////////////////////////////////////////////////////////////////////
+static inline REAL labUtil(const REAL& A, const REAL& B, const REAL& alpha,
+			   const REAL& eta, const REAL& frisch,
+			   const REAL& psi, REAL& x)
+{
+  const REAL e = 1 + 1/frisch;
+  const REAL l = staticLabor(A, B, alpha, eta, frisch, psi, x);
+  const REAL c = A*pow(l,1-alpha) + B;
+  return pow(c,1-eta)/(1-eta) - psi*pow(l,e)/e;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to tabulate static utility with elastic labor in a band
+/// around the maximizing future capital.
+///
+/// @details Labor is a static choice given capital k = K(i), TFP z = Z(j)
+/// and future capital k' = K(kp), so that the period utility maximized over
+/// labor does not change between iterations of the value function. Since a
+/// table over all feasible k' would hold nk*nk*nz values, only a band of
+/// nb = U.rows() consecutive future capital indices is kept for each state:
+/// column i + nk*j of U holds the utilities for k' = K(klo(i,j)),...,
+/// K(klo(i,j)+nb-1), of which those beyond khi(i,j) (the largest k' with
+/// nonnegative consumption at full time endowment, as in @link vfStep
+/// @endlink) are not used.
+///
+/// @details A column is (re)computed if klo(i,j) < 0 or if the policy
+/// G(i,j) lies on an edge of the band which is not a bound of the feasible
+/// set, so that the maximum may lie outside the band. The maximum of the
+/// period utility plus beta times the expected continuation value given V0
+/// over all feasible k' is then found by a binary search, as in @link
+/// binaryMax @endlink, with the utilities computed as needed, and the band
+/// is centred on it. Labor is obtained from @link staticLabor @endlink
+/// started at the solution for the previous k'. The capital indices are
+/// divided among OpenMP threads with a static schedule.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] K Grid of capital values.
+/// @param [in] Z Grid of TFP values.
+/// @param [in] P TFP transition matrix.
+/// @param [in] frisch Frisch elasticity of labor supply.
+/// @param [in] psi Weight of the disutility of labor.
+/// @param [in] V0 Value function giving the continuation values.
+/// @param [in] G Policy function (index of future capital) of the last
+/// maximization over the bands.
+/// @param [in,out] U Static utility (nb x nk*nz, sized by the caller).
+/// @param [in,out] klo Smallest future capital index of each band (nk x
+/// nz), set to -1 by the caller to compute all columns.
+/// @param [out] khi Largest feasible future capital index (nk x nz).
+///
+/// @returns Number of columns computed.
+///
+//////////////////////////////////////////////////////////////////////////////
+int laborTab(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	     const MatrixXR& P, const REAL& frisch, const REAL& psi,
+	     const MatrixXR& V0, const MatrixXi& G, MatrixXR& U,
+	     MatrixXi& klo, MatrixXi& khi)
+{
+
+  // Basic parameters
+  const int nk = param.nk;
+  const int nz = param.nz;
+  const int nb = U.rows();
+  const REAL eta = param.eta;
+  const REAL beta = param.beta;
+  const REAL alpha = param.alpha;
+  const REAL delta = param.delta;
+
+  // expected continuation values
+  MatrixXR EV;
+  EV.noalias() = V0*P.transpose();
+
+  khi.resize(nk, nz);
+  int count = 0;
+  REAL A, depK, x;
+#pragma omp parallel for schedule(static) private(A,depK,x) reduction(+:count)
+  for(int i = 0 ; i < nk ; ++i){
+    depK = (1-delta)*K(i);
+    for(int j = 0 ; j < nz ; ++j){
+      A = Z(j)*pow(K(i),alpha);
+
+      // keep the band unless the policy is on an interior edge
+      int kb = klo(i,j);
+      if(kb >= 0 && !(G(i,j) == kb && kb > 0) &&
+	 !(G(i,j) == kb+nb-1 && kb+nb-1 < khi(i,j))) continue;
+      ++count;
+
+      // consumption nonnegativity at full time endowment
+      int kh = binaryVal(A + depK, K);
+      if(K[kh] > A + depK) kh -= 1;
+      khi(i,j) = kh;
+
+      // maximum over the feasible future capital
+      int kslo = 0, kshi = kh, ksmid;
+      REAL wlo, whi;
+      while(kshi-kslo > 2){
+	ksmid = (kslo + kshi)/2;
+	x = 0.0;
+	wlo = labUtil(A, depK-K(ksmid), alpha, eta, frisch, psi, x) +
+	  beta*EV(ksmid,j);
+	whi = labUtil(A, depK-K(ksmid+1), alpha, eta, frisch, psi, x) +
+	  beta*EV(ksmid+1,j);
+	if(whi > wlo){
+	  kslo = ksmid;
+	} else {
+	  kshi = ksmid+1;
+	}
+      }
+
+      // band centred on the maximum
+      kb = (kslo+kshi)/2 - nb/2;
+      if(kb > kh-nb+1) kb = kh-nb+1;
+      if(kb < 0) kb = 0;
+      klo(i,j) = kb;
+
+      // static utility over the feasible future capital in the band
+      x = 0.0;
+      for(int kp = kb ; kp <= kh && kp < kb+nb ; ++kp){
+	U(kp-kb,i+nk*j) = labUtil(A, depK-K(kp), alpha, eta, frisch, psi, x);
+      }
+    }
+  }
+  return count;
+}
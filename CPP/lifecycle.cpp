@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file lifecycle.cpp
+///
+/// @brief File containing main function for the finite horizon growth
+/// model.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+
+using namespace std;
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @fn main()
+///
+/// @brief Main function for the finite horizon growth model.
+///
+/// @details This function solves the growth model of `main' over T ages
+/// by backward induction from a zero terminal value (see @link vfBackward
+/// @endlink), keeping the policy function of every age in compact form
+/// (see @link polHist @endlink), and simulates nAgents life cycles from
+/// the middle of the capital and TFP grids with TFP drawn by @link zDraw
+/// @endlink from uniforms of @link cbrng @endlink.
+///
+/// @details Usage: `./lifecycle [T nAgents]' (default 60 10000). The value
+/// and policy functions at age 0 are written to `valFunLifeCPP.dat' and
+/// `polFunLifeCPP.dat' in the format of `main', the mean capital at each
+/// age to `lifeKCPP.dat', and `lifecycleCPP.dat' holds the solution time,
+/// the number of ages, the bytes used by the stored policies and by the
+/// same policies stored as ints, and the number of simulated agent-ages
+/// per second.
+///
+/// @returns 0 upon successful completion, 1 otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+
+  // admin
+  int i, j;
+  double tic = curr_second(); // Start time
+
+  // Load parameters
+  parameters params;
+  params.load("../parameters.txt");
+  const int T = argc > 2 ? atoi(argv[1]) : 60;
+  const int nAgents = argc > 2 ? atoi(argv[2]) : 10000;
+  if(T < 1 || nAgents < 1){
+    cerr << "Usage: ./lifecycle [T nAgents] with T, nAgents > 0" << endl;
+    return 1;
+  }
+  const int nk = params.nk;
+  const int nz = params.nz;
+
+  // grids
+  VectorXR K(nk);
+  VectorXR Z(nz);
+  MatrixXR P(nz, nz);
+  ar1(params, Z, P);
+  kGrid(params, Z, K);
+
+  // backward induction from a zero terminal value
+  MatrixXR V = MatrixXR::Zero(nk, nz);
+  polHist H;
+  if(!vfBackward(params, K, Z, P, T, V, H)){
+    cerr << "Policy indices do not fit the compact storage" << endl;
+    return 1;
+  }
+  double solTime = curr_second() - tic;
+  const size_t bytes = H.off.size()*sizeof(unsigned short) +
+    H.base.size()*sizeof(int);
+  const size_t bytesInt = (size_t)T*nk*nz*sizeof(int);
+
+  // simulated life cycles (capital by age, summed over agents in a fixed
+  // order)
+  MatrixXR Pc(nz, nz);
+  Pc.col(0) = P.col(0);
+  for(int l = 1 ; l < nz ; ++l) Pc.col(l) = Pc.col(l-1) + P.col(l);
+  MatrixXR kPath(T, nAgents);
+  tic = curr_second();
+#pragma omp parallel for schedule(static)
+  for(int a = 0 ; a < nAgents ; ++a){
+    int ia = nk/2, ja = nz/2;
+    for(int t = 0 ; t < T ; ++t){
+      kPath(t,a) = K(ia);
+      ia = H(ia, ja, t);
+      ja = zDraw(cbrng(1, a, t), ja, Pc);
+    }
+  }
+  double simTime = curr_second() - tic;
+  const VectorXR meanK = kPath.rowwise().sum()/nAgents;
+
+  // write to file (column major)
+  ofstream fileLife, fileK, fileValue, filePolicy;
+  fileValue.precision(10);
+  filePolicy.precision(10);
+  fileK.precision(10);
+  fileLife.open("lifecycleCPP.dat");
+  fileK.open("lifeKCPP.dat");
+  fileValue.open("valFunLifeCPP.dat");
+  filePolicy.open("polFunLifeCPP.dat");
+  fileLife << solTime << endl;
+  fileLife << T << endl;
+  fileLife << bytes << endl;
+  fileLife << bytesInt << endl;
+  fileLife << (REAL)nAgents*T/simTime << endl;
+  for(int t = 0 ; t < T ; ++t) fileK << meanK(t) << endl;
+  fileValue << nk << endl;
+  fileValue << nz << endl;
+  filePolicy << nk << endl;
+  filePolicy << nz << endl;
+  for(j = 0 ; j < nz ; ++j){
+    for(i = 0 ; i < nk ; ++i){
+      fileValue << V(i,j) << endl;
+      filePolicy << H(i,j,0) << endl;
+    }
+  }
+  fileLife.close();
+  fileK.close();
+  fileValue.close();
+  filePolicy.close();
+
+  return 0;
+
+}
@@ -25,6 +25,7 @@
 #include <Eigen/Dense>
 #include <iostream>
 #include <fstream>
+#include <stdlib.h>
 
 using namespace std;
 using namespace Eigen;
@@ -43,6 +44,49 @@ using namespace Eigen;
 /// supercomputer under your desk: Solving dynamic equilibrium models with
 /// graphics processors", Journal of Economic Dynamics & Control, 35, 386-393.
 ///
+/// @details If the environment variable VFI_CACHE names a directory,
+/// solutions are looked up in and stored to a content-addressed cache in
+/// that directory (see @link cacheLoad @endlink), whose size is limited to
+/// VFI_CACHE_MB megabytes (1024 by default).
+///
+/// @details The solver matrices are allocated once by @link hugeAlloc
+/// @endlink, solved in place, and first touched by the OpenMP threads
+/// which update them, so that the rows which each thread writes reside on
+/// its own NUMA node. The continuation values of every state are read over
+/// nearly the whole capital grid, and so from all nodes. Pages are placed
+/// whole: since the matrices are column major, a thread's rows of a column
+/// (nk*sizeof(REAL)/nThreads bytes) share a 2 MB huge page with those of
+/// its neighbours unless they span several huge pages, so that huge pages
+/// and placement by node exclude each other on all but very large grids.
+/// Set VFI_HUGEPAGES to `off' to keep the placement by node. If VFI_NUMA
+/// is `interleave', pages are instead interleaved across nodes (see @link
+/// numaInterleave @endlink). The read bandwidth of each node over its own
+/// rows of the value function is written to `numaCPP.dat'.
+///
+/// @details Expectations use a banded approximation of the transition
+/// matrix (see @link pBand @endlink). The mean band width, the largest
+/// probability mass dropped from a row and a bound on the resulting error
+/// in the value function are written to `truncCPP.dat'.
+///
+/// @details With Epstein-Zin preferences (gamma > 0 in the parameter
+/// file), the value function is in units of U^(1-eta)/(1-eta) (see @link
+/// ezExp @endlink) and the Euler equation errors and simulations assume
+/// CRRA utility. The time of one iteration from the solution with
+/// Epstein-Zin and with CRRA preferences, and their ratio, are written to
+/// `ezCPP.dat'.
+///
+/// @details If VFI_GUARD is a nonzero integer, the maximization is guarded
+/// against nonconcave objectives (see @link binaryMaxGuard @endlink). The
+/// number of states in which concavity is violated in the first iteration
+/// and in an iteration from the solution, and the time of one iteration
+/// from the solution with and without the guard, are written to
+/// `guardCPP.dat'.
+///
+/// @details If VFI_PIN is set, OpenMP threads are pinned to CPUs (see
+/// @link pinThreads @endlink) before any allocation, and the placement of
+/// each thread (thread, CPU, package, core, hardware thread and NUMA node)
+/// is written to `pinCPP.dat'.
+///
 /// @returns 0 upon successful completion, 1 otherwise.
 ///
 //////////////////////////////////////////////////////////////////////////////
@@ -50,52 +94,222 @@ int main()
 {
 
   // admin
-  int imax;
-  REAL diff = 1.0;
-  int i, j, l;
+  int i, j;
   double tic = curr_second(); // Start time
 
+  // optional pinning of threads to CPUs
+  const char* pin = getenv("VFI_PIN");
+  MatrixXi pinMap;
+  if(pin != NULL && !pinThreads(pin, pinMap)){
+    cerr << "Could not pin threads with VFI_PIN=" << pin << endl;
+  }
+
+  // optional interleaving of pages across NUMA nodes
+  const char* numa = getenv("VFI_NUMA");
+  if(numa != NULL && string(numa) == "interleave" && !numaInterleave()){
+    cerr << "Could not interleave memory across NUMA nodes" << endl;
+  }
+
   // Load parameters
   parameters params;
   params.load("../parameters.txt");
+  const char* guard = getenv("VFI_GUARD");
+  if(guard != NULL) params.guard = atoi(guard);
   int nk = params.nk;
   int nz = params.nz;
 
-  // allocate variables in host memory
+  // allocate variables in host memory; the value and policy functions
+  // are backed by huge pages where available (see hugeAlloc)
   VectorXR K(nk);
   VectorXR Z(nz);
   MatrixXR P(nz, nz);
-  MatrixXR V0(nk, nz);
-  MatrixXR V(nk, nz);
-  MatrixXi G(nk, nz);
+  const size_t nb = (size_t)nk*nz;
+  int kind0, kind1, kindG;
+  REAL* buf0 = (REAL*)hugeAlloc(nb*sizeof(REAL), kind0);
+  REAL* buf1 = (REAL*)hugeAlloc(nb*sizeof(REAL), kind1);
+  int* bufG = (int*)hugeAlloc(nb*sizeof(int), kindG);
+  if(buf0 == NULL || buf1 == NULL || bufG == NULL){
+    cerr << "Could not allocate the value and policy functions" << endl;
+    return 1;
+  }
+  Map<MatrixXR> V0(buf0, nk, nz), V(buf1, nk, nz);
+  Map<MatrixXi> G(bufG, nk, nz);
+
+  // first touch with the partition of vfStep, so that the rows which each
+  // thread writes reside on its own NUMA node (up to the page size)
+#pragma omp parallel
+  for(int jz = 0 ; jz < nz ; ++jz){
+#pragma omp for schedule(static) nowait
+    for(int ix = 0 ; ix < nk ; ++ix){
+      V0(ix,jz) = 0.0;
+      V(ix,jz) = 0.0;
+      G(ix,jz) = 0;
+    }
+  }
 
-  // compute TFP grid, capital grid and initial VF
+  // compute TFP grid and capital grid
   ar1(params, Z, P);
   kGrid(params, Z, K);
-  vfInit(params, Z, V0);
-
-  // iterate
-  int count = 0;
-  while(fabs(diff) > params.tol){
-    vfStep(params, K, Z, P, V0, V, G);
-    diff = (V-V0).array().abs().maxCoeff();
-    V0 = V;
-    ++count;
-    //cout << "Iteration: " << count << ", Max Value Function Diff: " << diff << endl;
+
+  // look up the solution cache (directory $VFI_CACHE, if set)
+  const char* cacheDir = getenv("VFI_CACHE");
+  if(cacheDir == NULL || !cacheLoad(cacheDir, params, V, G)){
+
+    // compute initial VF and iterate
+    vfInit(params, Z, V0);
+    vfSolve(params, K, Z, P, V0, V, G);
+
+    // store the solution, within a budget of $VFI_CACHE_MB megabytes
+    if(cacheDir != NULL){
+      const char* budget = getenv("VFI_CACHE_MB");
+      cacheStore(cacheDir, params, V, G,
+		 (size_t)((budget != NULL ? atof(budget) : 1024)*1048576));
+    }
   }
 
   // Compute solution time
   double toc = curr_second();
   double solTime  = toc - tic;
 
+  // error due to truncation of the transition matrix: one Bellman step
+  // with the full matrix from the solution bounds the distance to the
+  // untruncated fixed point (including the convergence error)
+  MatrixXR Pt;
+  VectorXi plo, plen;
+  const REAL dropped = pBand(P, params.pTol, Pt, plo, plen);
+  REAL truncErr = 0.0;
+  if(plen.sum() < nz*nz){
+    parameters full = params;
+    full.pTol = 0.0;
+    MatrixXR V1(nk, nz);
+    MatrixXi G1(nk, nz);
+    vfStep(full, K, Z, P, V, V1, G1);
+    truncErr = (V1-V).array().abs().maxCoeff()/(1-params.beta);
+  }
+
+  // cost of an iteration with Epstein-Zin relative to CRRA preferences
+  double ezTime = 0.0, crraTime = 0.0;
+  if(params.gamma > 0){
+    const int nRep = 20;
+    parameters crra = params;
+    crra.gamma = 0.0;
+    MatrixXR V1(nk, nz);
+    MatrixXi G1(nk, nz);
+    tic = curr_second();
+    for(i = 0 ; i < nRep ; ++i) vfStep(params, K, Z, P, V, V1, G1);
+    ezTime = (curr_second() - tic)/nRep;
+    tic = curr_second();
+    for(i = 0 ; i < nRep ; ++i) vfStep(crra, K, Z, P, V, V1, G1);
+    crraTime = (curr_second() - tic)/nRep;
+  }
+
+  // concavity violations and cost of the guarded maximization
+  int nBadInit = 0, nBadSol = 0;
+  double guardTime = 0.0, plainTime = 0.0;
+  if(params.guard){
+    const int nRep = 20;
+    parameters plain = params;
+    plain.guard = 0;
+    MatrixXR V1(nk, nz);
+    MatrixXi G1(nk, nz);
+    vfInit(params, Z, V1);
+    nBadInit = vfStep(params, K, Z, P, V1, V0, G1);
+    tic = curr_second();
+    for(i = 0 ; i < nRep ; ++i) nBadSol = vfStep(params, K, Z, P, V, V1, G1);
+    guardTime = (curr_second() - tic)/nRep;
+    tic = curr_second();
+    for(i = 0 ; i < nRep ; ++i) vfStep(plain, K, Z, P, V, V1, G1);
+    plainTime = (curr_second() - tic)/nRep;
+  }
+
+  // Euler equation errors on and off the grid (not part of solution time)
+  tic = curr_second();
+  eulerStats euler;
+  eulerErr(params, K, Z, P, G, 10*nk, euler);
+  double eulerTime = curr_second() - tic;
+
+  // simulate a panel of economies under the policy
+  const int nAgents = 1000;
+  const int nPeriods = 1000;
+  const int nBurn = 100;
+  tic = curr_second();
+  simStats sim;
+  simulate(params, K, Z, P, G, nAgents, nPeriods, nBurn, 1, false, sim);
+  double simTime = curr_second() - tic;
+
+  // stationary distribution over (k,z) implied by the policy (Anderson
+  // acceleration of depth 5)
+  MatrixXR Kp(nk, nz);
+  for(j = 0 ; j < nz ; ++j){
+    for(i = 0 ; i < nk ; ++i) Kp(i,j) = K(G(i,j));
+  }
+  SpMatR T;
+  transOp(params, K, P, Kp, T);
+  VectorXR mu;
+  statDist(T, 5, params.tol, 1000000, mu);
+  writeBin("distCPP.bin", Map<MatrixXR>(mu.data(), nk, nz));
+
+  // impulse responses to a one standard deviation TFP shock
+  MatrixXR R;
+  irf(params, K, Z, Kp, T, mu, 100, R);
+  writeBin("irfCPP.bin", R);
+
+  // per-node read bandwidth over the solver's partition of V
+  VectorXR bw;
+  numaBandwidth(V, 20, bw);
+
   // write to file (column major)
-  ofstream fileSolTime, fileValue, filePolicy;
+  ofstream fileTrunc, fileNuma, fileSolTime, fileValue, filePolicy, fileEuler, fileSim;
   fileValue.precision(10);
   filePolicy.precision(10);
   fileSolTime.open("solTimeCPP.dat");
   fileValue.open("valFunCPP.dat");
   filePolicy.open("polFunCPP.dat");
+  fileEuler.open("eulerErrCPP.dat");
+  fileSim.open("simCPP.dat");
+  fileTrunc.open("truncCPP.dat");
+  fileTrunc << (REAL)plen.sum()/nz << endl;
+  fileTrunc << dropped << endl;
+  fileTrunc << truncErr << endl;
+  fileTrunc.close();
+  if(params.gamma > 0){
+    ofstream fileEZ("ezCPP.dat");
+    fileEZ << ezTime << endl;
+    fileEZ << crraTime << endl;
+    fileEZ << ezTime/crraTime << endl;
+    fileEZ.close();
+  }
+  if(params.guard){
+    ofstream fileGuard("guardCPP.dat");
+    fileGuard << nBadInit << endl;
+    fileGuard << nBadSol << endl;
+    fileGuard << guardTime << endl;
+    fileGuard << plainTime << endl;
+    fileGuard.close();
+  }
+  fileNuma.open("numaCPP.dat");
+  if(pinMap.size() > 0){
+    ofstream filePin("pinCPP.dat");
+    filePin << pinMap << endl;
+    filePin.close();
+  }
+  for(i = 0 ; i < bw.size() ; ++i) fileNuma << bw(i) << endl;
   fileSolTime << solTime << endl;
+  fileEuler << euler.maxGrid << endl;
+  fileEuler << euler.meanGrid << endl;
+  fileEuler << euler.maxTest << endl;
+  fileEuler << euler.meanTest << endl;
+  fileEuler << eulerTime << endl;
+  fileSim << sim.meanK << endl;
+  fileSim << sim.sdK << endl;
+  fileSim << sim.meanY << endl;
+  fileSim << sim.sdY << endl;
+  fileSim << sim.meanC << endl;
+  fileSim << sim.sdC << endl;
+  fileSim << sim.meanI << endl;
+  fileSim << sim.sdI << endl;
+  fileSim << sim.acY << endl;
+  fileSim << (REAL)nAgents*(nPeriods+nBurn)/simTime << endl;
   fileValue << nk << endl;
   fileValue << nz << endl;
   filePolicy << nk << endl;
@@ -109,6 +323,12 @@ int main()
   fileSolTime.close();
   fileValue.close();
   filePolicy.close();
+  fileEuler.close();
+  fileSim.close();
+  fileNuma.close();
+  hugeFree(buf0, nb*sizeof(REAL), kind0);
+  hugeFree(buf1, nb*sizeof(REAL), kind1);
+  hugeFree(bufG, nb*sizeof(int), kindG);
 
   return 0;
 
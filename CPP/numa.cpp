@@ -0,0 +1,184 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file numa.cpp
+///
+/// @brief File containing functions for NUMA-aware memory placement.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+using namespace std;
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to parse a list of CPUs.
+///
+/// @param [in] list CPU list in the format of /sys (e.g. "0-3,8-11").
+/// @param [out] cpus CPU numbers, in the order listed.
+///
+/// @returns Number of CPUs.
+///
+//////////////////////////////////////////////////////////////////////////////
+int cpuList(const string& list, VectorXi& cpus)
+{
+  vector<int> v;
+  stringstream fields(list);
+  string range;
+  while(getline(fields, range, ',')){
+    if(range.find_first_of("0123456789") == string::npos) continue;
+    const int lo = atoi(range.c_str());
+    const size_t dash = range.find('-');
+    const int hi = dash != string::npos ? atoi(range.c_str()+dash+1) : lo;
+    for(int cpu = lo ; cpu <= hi ; ++cpu) v.push_back(cpu);
+  }
+  cpus = Map<VectorXi>(v.data(), v.size());
+  return v.size();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to map CPUs to NUMA nodes.
+///
+/// @details This function reads the CPU lists of the nodes in
+/// /sys/devices/system/node. If the directory is unavailable, all CPUs are
+/// assigned to node 0.
+///
+/// @param [out] cpuNode Node of each CPU (indexed by CPU number).
+///
+/// @returns Number of NUMA nodes.
+///
+//////////////////////////////////////////////////////////////////////////////
+int numaNodes(VectorXi& cpuNode)
+{
+  const int nCpu = sysconf(_SC_NPROCESSORS_CONF);
+  cpuNode = VectorXi::Zero(nCpu > 0 ? nCpu : 1);
+  int nNode = 0;
+  for(int node = 0 ; node < 1024 ; ++node){
+    stringstream path;
+    path << "/sys/devices/system/node/node" << node << "/cpulist";
+    ifstream fileIn(path.str().c_str());
+    if(!fileIn) break;
+    ++nNode;
+
+    string list;
+    getline(fileIn, list);
+    VectorXi cpus;
+    cpuList(list, cpus);
+    for(int ix = 0 ; ix < cpus.size() ; ++ix){
+      if(cpus(ix) < cpuNode.size()) cpuNode(cpus(ix)) = node;
+    }
+  }
+  return nNode > 0 ? nNode : 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to interleave subsequent allocations across NUMA nodes.
+///
+/// @details This function sets the memory policy of the calling thread
+/// (inherited by threads it creates) so that pages allocated afterwards
+/// are placed round robin on all nodes. This spreads bandwidth evenly when
+/// the threads which touch a buffer first are not those which use it.
+///
+/// @returns true upon success, false otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+bool numaInterleave()
+{
+  VectorXi cpuNode;
+  const int nNode = numaNodes(cpuNode);
+  vector<unsigned long> mask((nNode+63)/64, 0);
+  for(int node = 0 ; node < nNode ; ++node) mask[node/64] |= 1UL << (node%64);
+  return syscall(SYS_set_mempolicy, MPOL_INTERLEAVE, mask.data(),
+		 64*mask.size()) == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to measure the read bandwidth of each NUMA node.
+///
+/// @details This function reads X repeatedly in parallel with the same
+/// static partition of capital indices as @link vfStep @endlink, so that
+/// each thread reads the rows it first touched (those which it writes in
+/// @link vfStep @endlink, whose reads of continuation values instead span
+/// nearly all rows), and attributes the bytes read by each thread to the
+/// node of the CPU on which it runs. The bandwidth of a node is the number
+/// of bytes read by its threads divided by the longest time among them. A
+/// node whose bandwidth falls well short of the others indicates that the
+/// rows of its threads are on remote pages, for instance because huge
+/// pages hold the rows of threads on several nodes.
+///
+/// @param [in] X Matrix to read (nk x nz).
+/// @param [in] nRep Number of passes over X.
+/// @param [out] bw Bandwidth of each node in GB/s.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void numaBandwidth(const Ref<const MatrixXR>& X, const int& nRep,
+		   VectorXR& bw)
+{
+  VectorXi cpuNode;
+  const int nNode = numaNodes(cpuNode);
+  const int nk = X.rows();
+  const int nz = X.cols();
+  VectorXR bytes = VectorXR::Zero(nNode);
+  VectorXR time = VectorXR::Zero(nNode);
+  REAL total = 0.0;
+#pragma omp parallel reduction(+:total)
+  {
+    const int cpu = sched_getcpu();
+    const int node = cpu >= 0 && cpu < cpuNode.size() ? cpuNode(cpu) : 0;
+    REAL sum = 0.0, nRead = 0.0;
+    double tic = curr_second();
+    for(int rep = 0 ; rep < nRep ; ++rep){
+      for(int j = 0 ; j < nz ; ++j){
+#pragma omp for schedule(static) nowait
+	for(int i = 0 ; i < nk ; ++i){
+	  sum += X(i,j);
+	  nRead += sizeof(REAL);
+	}
+      }
+    }
+    double toc = curr_second() - tic;
+    total += sum;
+#pragma omp critical
+    {
+      bytes(node) += nRead;
+      time(node) = max(time(node), (REAL)toc);
+    }
+  }
+
+  // keep the reads from being optimized away
+  volatile REAL sink = total;
+  (void)sink;
+  bw.resize(nNode);
+  for(int node = 0 ; node < nNode ; ++node){
+    bw(node) = time(node) > 0 ? bytes(node)/time(node)/1e9 : 0.0;
+  }
+}
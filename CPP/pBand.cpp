@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file pBand.cpp
+///
+/// @brief File containing function to compute a banded approximation of
+/// the TFP transition matrix.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute a banded approximation of the TFP transition
+/// matrix.
+///
+/// @details For each row j of P, this function finds the smallest band
+/// [lo(j), lo(j)+len(j)) of columns outside of which all probabilities are
+/// below tol in absolute value, sets the probabilities outside the band to
+/// zero and renormalizes the row to sum to one. Rows of discretized AR1
+/// processes with many states are effectively banded, so that expectations
+/// over the band cost O(len) rather than O(nz). The band is used only if it
+/// removes at least a quarter of the entries of P; otherwise (or if tol is
+/// not positive) Pt is equal to P and every band is the full row.
+///
+/// @param [in] P TFP transition matrix.
+/// @param [in] tol Truncation tolerance.
+/// @param [out] Pt Truncated transition matrix (zero outside the bands).
+/// @param [out] lo First column of the band of each row.
+/// @param [out] len Width of the band of each row.
+///
+/// @returns Largest probability mass removed from a row (0 if P is not
+/// truncated).
+///
+//////////////////////////////////////////////////////////////////////////////
+REAL pBand(const MatrixXR& P, const REAL& tol, MatrixXR& Pt, VectorXi& lo,
+	   VectorXi& len)
+{
+  const int nz = P.rows();
+  lo = VectorXi::Zero(nz);
+  len = VectorXi::Constant(nz, nz);
+  Pt = P;
+  if(tol <= 0) return 0.0;
+
+  // band of each row
+  VectorXi blo(nz), blen(nz);
+  for(int j = 0 ; j < nz ; ++j){
+    int first = 0, last = nz-1;
+    while(first < last && fabs(P(j,first)) < tol) ++first;
+    while(last > first && fabs(P(j,last)) < tol) --last;
+    blo(j) = first;
+    blen(j) = last-first+1;
+  }
+  if(4*blen.sum() > 3*nz*nz) return 0.0;
+
+  // truncate and renormalize
+  REAL dropped = 0.0, mass;
+  for(int j = 0 ; j < nz ; ++j){
+    mass = Pt.row(j).segment(blo(j), blen(j)).sum();
+    dropped = fmax(dropped, fabs(1-mass));
+    Pt.row(j).setZero();
+    Pt.row(j).segment(blo(j), blen(j)) = P.row(j).segment(blo(j), blen(j))/mass;
+  }
+  lo = blo;
+  len = blen;
+  return dropped;
+}
@@ -35,7 +35,10 @@ using namespace std;
 /// file must have 13 lines, each line beginning with a parameter value,
 /// followed by a comma and a character string describing the parameter. The
 /// order of the parameters must correspond to the order in the parameters
-/// class description.
+/// class description. An optional 14th line selects the discretization of
+/// TFP: 't' (Tauchen, the default), 'h' (Tauchen-Hussey) or 'r'
+/// (Rouwenhorst), and an optional 15th line the Epstein-Zin risk aversion
+/// gamma (0, the default, for CRRA utility).
 ///
 /// @param [in] fileName Name of file storing parameter values.
 ///
@@ -64,4 +67,57 @@ void parameters::load(const char* fileName)
   nk = atoi(params[8].c_str());
   nz = atoi(params[9].c_str());
   tol = atof(params[10].c_str());
+
+  // optional discretization method, after the two lines for other
+  // implementations
+  std::string method;
+  for(int ix = 0 ; ix < 3 ; ++ix){
+    method.clear();
+    getline(fileIn, method, ',');
+    getline(fileIn, trash);
+  }
+  method.erase(0, method.find_first_not_of(" \t\r\n"));
+  if(method == "h") zMethod = zTauchenHussey;
+  else if(method == "r") zMethod = zRouwenhorst;
+  else zMethod = zTauchen;
+
+  // optional Epstein-Zin risk aversion
+  std::string ezGamma;
+  getline(fileIn, ezGamma, ',');
+  gamma = atof(ezGamma.c_str());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to set a single parameter value by name.
+///
+/// @details This function is a parameters class method which assigns a
+/// value to the parameter whose name matches the class member name (e.g.
+/// "beta" or "nk"). Integer parameters are rounded to the nearest integer.
+///
+/// @param [in] name Name of the parameter.
+/// @param [in] value Parameter value.
+///
+/// @returns true if the name matched a parameter, false otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+bool parameters::set(const std::string& name, const REAL& value)
+{
+  if(name == "eta") eta = value;
+  else if(name == "beta") beta = value;
+  else if(name == "alpha") alpha = value;
+  else if(name == "delta") delta = value;
+  else if(name == "mu") mu = value;
+  else if(name == "rho") rho = value;
+  else if(name == "sigma") sigma = value;
+  else if(name == "lambda") lambda = value;
+  else if(name == "nk") nk = (int)(value+0.5);
+  else if(name == "nz") nz = (int)(value+0.5);
+  else if(name == "tol") tol = value;
+  else if(name == "zMethod") zMethod = (int)(value+0.5);
+  else if(name == "pTol") pTol = value;
+  else if(name == "gamma") gamma = value;
+  else if(name == "guard") guard = (int)(value+0.5);
+  else return false;
+  return true;
 }
@@ -0,0 +1,211 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file pin.cpp
+///
+/// @brief File containing function to pin OpenMP threads to CPUs.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdlib.h>
+#include <sched.h>
+#include <omp.h>
+
+using namespace std;
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @class cpuTopo
+///
+/// @brief Object to store the location of a CPU in the machine topology.
+///
+//////////////////////////////////////////////////////////////////////////////
+class cpuTopo{
+ public:
+  int cpu; ///< CPU number.
+  int package; ///< Physical package (socket).
+  int core; ///< Core within the package.
+  int smt; ///< Rank of the CPU among the hardware threads of its core.
+  int node; ///< NUMA node.
+};
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to read the first line of a topology file.
+///
+/// @param [in] cpu CPU number.
+/// @param [in] name File name in /sys/devices/system/cpu/cpuN/topology.
+///
+/// @returns Contents of the line (empty if unavailable).
+///
+//////////////////////////////////////////////////////////////////////////////
+static string topoRead(const int& cpu, const char* name)
+{
+  stringstream path;
+  path << "/sys/devices/system/cpu/cpu" << cpu << "/topology/" << name;
+  ifstream fileIn(path.str().c_str());
+  string line;
+  getline(fileIn, line);
+  return line;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to order CPUs for compact placement.
+///
+/// @details First hardware threads come first; within them, CPUs are
+/// ordered by package and core, so that consecutive threads share caches.
+///
+/// @param [in] a First CPU.
+/// @param [in] b Second CPU.
+///
+/// @returns true if a precedes b.
+///
+//////////////////////////////////////////////////////////////////////////////
+static bool compactOrder(const cpuTopo& a, const cpuTopo& b)
+{
+  if(a.smt != b.smt) return a.smt < b.smt;
+  if(a.package != b.package) return a.package < b.package;
+  if(a.core != b.core) return a.core < b.core;
+  return a.cpu < b.cpu;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to order CPUs for scatter placement.
+///
+/// @details First hardware threads come first; within them, CPUs are
+/// ordered by core and then package, so that consecutive threads alternate
+/// between sockets and share their memory bandwidth.
+///
+/// @param [in] a First CPU.
+/// @param [in] b Second CPU.
+///
+/// @returns true if a precedes b.
+///
+//////////////////////////////////////////////////////////////////////////////
+static bool scatterOrder(const cpuTopo& a, const cpuTopo& b)
+{
+  if(a.smt != b.smt) return a.smt < b.smt;
+  if(a.core != b.core) return a.core < b.core;
+  if(a.package != b.package) return a.package < b.package;
+  return a.cpu < b.cpu;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to pin OpenMP threads to CPUs.
+///
+/// @details This function reads the topology of the CPUs available to the
+/// process from /sys/devices/system/cpu and binds OpenMP thread t of the
+/// thread pool to the t-th CPU (modulo their number) of an ordering given
+/// by spec:
+///
+///   `compact' fills the cores of one package before the next;
+///   `scatter' places consecutive threads on different packages;
+///   a list such as `0,2,4-7' gives the CPUs explicitly.
+///
+/// In both compact and scatter placement, second hardware threads (SMT
+/// siblings) of a core are used only after the first hardware thread of
+/// every core. Appending `:nosmt' (e.g. `scatter:nosmt') excludes them
+/// altogether. Since the OpenMP runtime keeps its threads between parallel
+/// regions, the binding applies to all later parallel regions with the
+/// same number of threads.
+///
+/// @param [in] spec Placement: compact, scatter or a CPU list, optionally
+/// followed by `:nosmt'.
+/// @param [out] map Resulting placement, one row per thread: thread, CPU,
+/// package, core, hardware thread and NUMA node.
+///
+/// @returns true upon success, false otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+bool pinThreads(const string& spec, MatrixXi& map)
+{
+  // topology of the CPUs available to the process
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return false;
+  VectorXi cpuNode;
+  numaNodes(cpuNode);
+  vector<cpuTopo> topo;
+  for(int cpu = 0 ; cpu < CPU_SETSIZE ; ++cpu){
+    if(!CPU_ISSET(cpu, &allowed)) continue;
+    cpuTopo t;
+    t.cpu = cpu;
+    t.package = atoi(topoRead(cpu, "physical_package_id").c_str());
+    t.core = atoi(topoRead(cpu, "core_id").c_str());
+    VectorXi sib;
+    cpuList(topoRead(cpu, "thread_siblings_list"), sib);
+    t.smt = (sib.array() < cpu).count();
+    t.node = cpu < cpuNode.size() ? cpuNode(cpu) : 0;
+    topo.push_back(t);
+  }
+
+  // order the CPUs
+  const size_t colon = spec.find(':');
+  const string place = spec.substr(0, colon);
+  const bool noSMT = colon != string::npos && spec.substr(colon+1) == "nosmt";
+  vector<cpuTopo> order;
+  if(place == "compact" || place == "scatter"){
+    order = topo;
+    sort(order.begin(), order.end(),
+	 place == "compact" ? compactOrder : scatterOrder);
+  } else {
+    VectorXi cpus;
+    if(cpuList(place, cpus) == 0) return false;
+    for(int ix = 0 ; ix < cpus.size() ; ++ix){
+      for(size_t jx = 0 ; jx < topo.size() ; ++jx){
+	if(topo[jx].cpu == cpus(ix)) order.push_back(topo[jx]);
+      }
+    }
+  }
+  if(noSMT){
+    vector<cpuTopo> first;
+    for(size_t ix = 0 ; ix < order.size() ; ++ix){
+      if(order[ix].smt == 0) first.push_back(order[ix]);
+    }
+    order.swap(first);
+  }
+  if(order.empty()) return false;
+
+  // bind each thread of the pool
+  const int nThread = omp_get_max_threads();
+  map.resize(nThread, 6);
+  bool ok = true;
+#pragma omp parallel num_threads(nThread) reduction(&&:ok)
+  {
+    const int tid = omp_get_thread_num();
+    const cpuTopo& t = order[tid % order.size()];
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(t.cpu, &set);
+    ok = sched_setaffinity(0, sizeof(set), &set) == 0;
+    map(tid,0) = tid;
+    map(tid,1) = t.cpu;
+    map(tid,2) = t.package;
+    map(tid,3) = t.core;
+    map(tid,4) = t.smt;
+    map(tid,5) = t.node;
+  }
+  return ok;
+}
@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file polHist.cpp
+///
+/// @brief File containing methods of the polHist class.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to allocate storage for the policies of all ages.
+///
+/// @details This function is a polHist class method which sizes the block
+/// bases and offsets for nAge policy functions of nk x nz values.
+///
+/// @param [in] nkIn Number of values in capital grid.
+/// @param [in] nzIn Number of values in TFP grid.
+/// @param [in] nAgeIn Number of ages.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void polHist::init(const int& nkIn, const int& nzIn, const int& nAgeIn)
+{
+  nk = nkIn;
+  nz = nzIn;
+  nAge = nAgeIn;
+  nBlock = ((nk-1) >> shift) + 1;
+  base.assign((size_t)nBlock*nz*nAge, 0);
+  off.assign((size_t)nk*nz*nAge, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to store the policy function of one age.
+///
+/// @details This function is a polHist class method which stores, for each
+/// block of capital indices, the smallest policy index in the block and
+/// the offset of every policy index from it.
+///
+/// @param [in] t Age.
+/// @param [in] G Policy function at age t (nk x nz).
+///
+/// @returns true upon success, false if the policy indices of a block
+/// span more than 65535 values.
+///
+//////////////////////////////////////////////////////////////////////////////
+bool polHist::store(const int& t, const MatrixXi& G)
+{
+  const int width = 1 << shift;
+  for(int j = 0 ; j < nz ; ++j){
+    const size_t col = j + (size_t)nz*t;
+    for(int b = 0 ; b < nBlock ; ++b){
+      const int lo = b*width;
+      const int n = lo+width > nk ? nk-lo : width;
+      const int gmin = G.col(j).segment(lo, n).minCoeff();
+      if(G.col(j).segment(lo, n).maxCoeff()-gmin > 65535) return false;
+      base[b + nBlock*col] = gmin;
+      for(int i = lo ; i < lo+n ; ++i) off[i + nk*col] = G(i,j) - gmin;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,58 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file polInterp.cpp
+///
+/// @brief File containing function to evaluate the capital policy off the
+/// grid.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to linearly interpolate the capital policy function.
+///
+/// @details This function evaluates the policy function at an arbitrary
+/// level of capital, conditional on a TFP index, by linear interpolation
+/// of the grid values K(G(.,j)). Values of capital outside of the grid are
+/// assigned the policy at the nearest endpoint.
+///
+/// @param [in] k Current level of capital.
+/// @param [in] j Index of current TFP value.
+/// @param [in] K Grid of capital values.
+/// @param [in] G Matrix storing policy function (indices of K).
+///
+/// @returns Interpolated value of future capital.
+///
+//////////////////////////////////////////////////////////////////////////////
+REAL polInterp(const REAL& k, const int& j, const VectorXR& K,
+	       const MatrixXi& G)
+{
+  const int nk = K.size();
+
+  // check if k is out of bounds
+  if(k <= K(0)) return K(G(0,j));
+  if(k >= K(nk-1)) return K(G(nk-1,j));
+
+  // otherwise interpolate between the bracketing grid points
+  const int ihi = binaryVal(k, K);
+  const int ilo = ihi-1;
+  const REAL w = (k-K(ilo))/(K(ihi)-K(ilo));
+  return (1-w)*K(G(ilo,j)) + w*K(G(ihi,j));
+}
@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file rng.cpp
+///
+/// @brief File containing counter-based random number generator.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief 64-bit mixing function.
+///
+/// @details Finalizer of the SplitMix64 generator, a bijection of 64-bit
+/// integers with good avalanche properties.
+///
+/// @param [in] x Integer to mix.
+///
+/// @returns Mixed integer.
+///
+//////////////////////////////////////////////////////////////////////////////
+static inline unsigned long long mix64(unsigned long long x)
+{
+  x = (x ^ (x >> 30))*0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27))*0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Counter-based uniform random number generator.
+///
+/// @details This function returns a uniform draw on [0,1) which is a pure
+/// function of a seed, a stream index and a counter. Since there is no
+/// generator state, draws for stream s and period t are identical no matter
+/// which thread computes them or in which order, so that parallel
+/// simulations are reproducible regardless of the number of threads.
+///
+/// @param [in] seed Global seed.
+/// @param [in] stream Stream index (e.g. simulated agent or economy).
+/// @param [in] ctr Counter within the stream (e.g. time period).
+///
+/// @returns Uniform draw on [0,1).
+///
+//////////////////////////////////////////////////////////////////////////////
+REAL cbrng(const unsigned long long& seed, const unsigned long long& stream,
+	   const unsigned long long& ctr)
+{
+  const unsigned long long key = mix64(seed ^ mix64(stream + 0x9E3779B97F4A7C15ULL));
+  const unsigned long long x = mix64(key + ctr*0x9E3779B97F4A7C15ULL);
+  return (x >> 11)*(1.0/9007199254740992.0);
+}
@@ -0,0 +1,327 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file service.cpp
+///
+/// @brief File containing main function for a persistent solver service.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @class shmBuffer
+///
+/// @brief POSIX shared memory segment holding the latest solution.
+///
+//////////////////////////////////////////////////////////////////////////////
+class shmBuffer{
+ public:
+  string name; ///< Name of the segment (for shm_open by clients).
+  int fd; ///< File descriptor of the segment.
+  void* addr; ///< Address of the mapping.
+  size_t size; ///< Size of the mapping in bytes.
+};
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to ensure that the shared memory segment is large enough.
+///
+/// @param [in,out] shm Shared memory segment.
+/// @param [in] size Required size in bytes.
+///
+/// @returns true upon success, false otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+static bool shmReserve(shmBuffer& shm, const size_t& size)
+{
+  if(size <= shm.size) return true;
+  if(shm.addr != NULL) munmap(shm.addr, shm.size);
+  shm.addr = NULL;
+  shm.size = 0;
+  if(ftruncate(shm.fd, size) != 0) return false;
+  void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, shm.fd, 0);
+  if(addr == MAP_FAILED) return false;
+  shm.addr = addr;
+  shm.size = size;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to serve solve requests on a stream.
+///
+/// @details Each request is a single line of `name=value' pairs, separated
+/// by commas or spaces, which modify the base calibration (e.g.
+/// `beta=0.98,eta=2.5'). An empty request solves the base calibration and
+/// `quit' ends the stream. The reply to each request is a single line,
+/// either
+///
+///   `ok shm nk nz iter solTime warm'
+///
+/// where shm is the name of the shared memory segment holding the value
+/// function (nk*nz REAL values, column major) followed by the policy
+/// function (nk*nz 32-bit ints, column major), iter is the number of
+/// iterations, solTime the solution time in seconds and warm is 1 if the
+/// solve was warm started from the previous solution and 0 otherwise, or
+///
+///   `error message'.
+///
+/// The solution is computed in place in the segment, and the two
+/// segments alternate, so that the other one holds the previous solution,
+/// from which the solve is warm started. The segment named in a reply is
+/// valid until the next request on any stream.
+///
+/// @param [in] in Stream of requests.
+/// @param [in] out Stream of replies.
+/// @param [in] base Base calibration.
+/// @param [in,out] shm Two shared memory segments for solutions.
+/// @param [in,out] cur Index of the segment holding the previous solution.
+/// @param [in,out] last Calibration of the previous solution (nk = 0 if
+/// none).
+/// @param [in,out] K Capital grid of the previous solution.
+/// @param [in,out] Z TFP grid of the previous solution.
+/// @param [in,out] P TFP transition matrix of the previous solution.
+/// @param [in,out] V0 Workspace for the initial value function.
+///
+/// @returns false if the stream asked the service to quit, true otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+static bool serve(FILE* in, FILE* out, const parameters& base, shmBuffer* shm,
+		  int& cur, parameters& last, VectorXR& K, VectorXR& Z,
+		  MatrixXR& P, MatrixXR& V0)
+{
+  char* buf = NULL;
+  size_t len = 0;
+  bool more = true;
+  VectorXR Kn, Zn;
+  while(getline(&buf, &len, in) > 0){
+    string line(buf);
+    line.erase(line.find_last_not_of(" \t\r\n")+1);
+    if(line == "quit"){
+      more = false;
+      break;
+    }
+
+    // parse the calibration
+    parameters p = base;
+    string field, error;
+    for(size_t ix = 0 ; ix < line.size() ; ++ix){
+      if(line[ix] == ',') line[ix] = ' ';
+    }
+    stringstream fields(line);
+    while(fields >> field){
+      size_t eq = field.find('=');
+      if(eq == string::npos ||
+	 !p.set(field.substr(0, eq), atof(field.substr(eq+1).c_str()))){
+	error = "unknown parameter " + field;
+	break;
+      }
+    }
+    if(error.empty() && (p.nk < 2 || p.nz < 2)) error = "invalid grid size";
+    if(!error.empty()){
+      fprintf(out, "error %s\n", error.c_str());
+      fflush(out);
+      continue;
+    }
+
+    // the solution is computed in the segment which does not hold the
+    // previous solution
+    double tic = curr_second();
+    shmBuffer& dst = shm[1-cur];
+    const size_t nV = sizeof(REAL)*p.nk*p.nz;
+    const size_t nG = sizeof(int)*p.nk*p.nz;
+    if(!shmReserve(dst, nV+nG)){
+      fprintf(out, "error could not allocate shared memory\n");
+      fflush(out);
+      continue;
+    }
+    Map<MatrixXR> V((REAL*)dst.addr, p.nk, p.nz);
+    Map<MatrixXi> G((int*)((char*)dst.addr+nV), p.nk, p.nz);
+
+    // grids are recomputed only when the relevant parameters change
+    const bool sameZ = last.nk > 0 && p.mu == last.mu && p.rho == last.rho &&
+      p.sigma == last.sigma && p.lambda == last.lambda && p.nz == last.nz &&
+      p.zMethod == last.zMethod;
+    const bool sameK = sameZ && p.alpha == last.alpha && p.beta == last.beta &&
+      p.delta == last.delta && p.nk == last.nk;
+    Zn = Z;
+    Kn = K;
+    if(!sameZ){
+      Zn.resize(p.nz);
+      P.resize(p.nz, p.nz);
+      ar1(p, Zn, P);
+    }
+    if(!sameK){
+      Kn.resize(p.nk);
+      kGrid(p, Zn, Kn);
+    }
+
+    // look up the cache or solve, warm starting from the previous solution
+    int iter = 0;
+    int warm = 0;
+    const char* cacheDir = getenv("VFI_CACHE");
+    const bool hit = cacheDir != NULL && cacheLoad(cacheDir, p, V, G);
+    if(!hit && last.nk > 0){
+      Map<const MatrixXR> Vprev((const REAL*)shm[cur].addr, last.nk, last.nz);
+      iter = vfSolveWarm(p, Kn, Zn, P, last.beta, K, Z, Vprev, V0, V, G);
+      warm = 1;
+    } else if(!hit){
+      V0.resize(p.nk, p.nz);
+      vfInit(p, Zn, V0);
+      iter = vfSolve(p, Kn, Zn, P, V0, V, G);
+    }
+    if(cacheDir != NULL && !hit){
+      const char* budget = getenv("VFI_CACHE_MB");
+      cacheStore(cacheDir, p, V, G,
+		 (size_t)((budget != NULL ? atof(budget) : 1024)*1048576));
+    }
+    double solTime = curr_second() - tic;
+    K.swap(Kn);
+    Z.swap(Zn);
+    last = p;
+    cur = 1-cur;
+    fprintf(out, "ok %s %d %d %d %.10g %d\n", dst.name.c_str(), p.nk, p.nz,
+	    iter, solTime, warm);
+    fflush(out);
+  }
+  free(buf);
+  return more;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @fn main()
+///
+/// @brief Main function for a persistent solver service.
+///
+/// @details This function keeps a solver resident so that repeated solves
+/// avoid process startup, parameter file parsing and allocation. The base
+/// calibration is loaded once from `../parameters.txt'; requests (see
+/// @link serve @endlink) are read from stdin, with replies on stdout, or,
+/// with `-s path', from clients connecting one at a time to a Unix domain
+/// socket at path. Workspaces, grids and the last solution are kept
+/// between requests, and each solve is warm started from the last solution
+/// with @link vfSolveWarm @endlink, unless the solution is found in the
+/// cache named by VFI_CACHE (see @link cacheLoad @endlink; iter is then
+/// 0). Solutions are computed directly in POSIX shared memory segments
+/// which clients map read-only, so that only a short reply line passes
+/// through the stream. SIGPIPE is ignored, so that a client disconnecting
+/// before its reply does not end the service.
+///
+/// @details Usage: `./service [-s path]'.
+///
+/// @returns 0 upon successful completion, 1 otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+  const char* sockPath = NULL;
+  if(argc > 2 && string(argv[1]) == "-s") sockPath = argv[2];
+  else if(argc > 1){
+    cerr << "Usage: " << argv[0] << " [-s path]" << endl;
+    return 1;
+  }
+
+  // Load base parameters
+  parameters base;
+  base.load("../parameters.txt");
+
+  // a client which disconnects before reading its reply must not end the
+  // service
+  signal(SIGPIPE, SIG_IGN);
+
+  // two shared memory segments for solutions, used in turn
+  shmBuffer shm[2];
+  for(int ix = 0 ; ix < 2 ; ++ix){
+    stringstream shmName;
+    shmName << "/vfiService." << getpid() << "." << ix;
+    shm[ix].name = shmName.str();
+    shm[ix].fd = shm_open(shm[ix].name.c_str(), O_RDWR | O_CREAT | O_TRUNC,
+			  0600);
+    shm[ix].addr = NULL;
+    shm[ix].size = 0;
+    if(shm[ix].fd < 0){
+      cerr << "Could not create shared memory segment " << shm[ix].name
+	   << endl;
+      if(ix > 0){
+	close(shm[0].fd);
+	shm_unlink(shm[0].name.c_str());
+      }
+      return 1;
+    }
+  }
+
+  // persistent state
+  parameters last = base;
+  last.nk = 0;
+  int cur = 0;
+  VectorXR K, Z;
+  MatrixXR P, V0;
+
+  int status = 0;
+  if(sockPath == NULL){
+    serve(stdin, stdout, base, shm, cur, last, K, Z, P, V0);
+  } else {
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, sockPath, sizeof(addr.sun_path)-1);
+    unlink(sockPath);
+    if(sock < 0 || bind(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+       listen(sock, 8) != 0){
+      cerr << "Could not listen on " << sockPath << endl;
+      status = 1;
+    } else {
+      bool more = true;
+      while(more){
+	int conn = accept(sock, NULL, NULL);
+	if(conn < 0) continue;
+	FILE* in = fdopen(conn, "r");
+	FILE* out = fdopen(dup(conn), "w");
+	more = serve(in, out, base, shm, cur, last, K, Z, P, V0);
+	fclose(in);
+	fclose(out);
+      }
+      close(sock);
+      unlink(sockPath);
+    }
+  }
+
+  // clean up
+  for(int ix = 0 ; ix < 2 ; ++ix){
+    if(shm[ix].addr != NULL) munmap(shm[ix].addr, shm[ix].size);
+    close(shm[ix].fd);
+    shm_unlink(shm[ix].name.c_str());
+  }
+  return status;
+}
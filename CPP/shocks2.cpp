@@ -0,0 +1,156 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file shocks2.cpp
+///
+/// @brief File containing main function for the growth model with TFP and
+/// investment-specific shocks.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+
+using namespace std;
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @fn main()
+///
+/// @brief Main function for the growth model with TFP and
+/// investment-specific shocks.
+///
+/// @details This function solves the growth model of `main' with a second,
+/// independent AR1 shock to the efficiency of investment (see @link
+/// vfStep2 @endlink), whose log has persistence rhoQ, innovation standard
+/// deviation sigmaQ and is discretized with nQ states by the method of the
+/// TFP process. TFP is as in `../parameters.txt', so that nz = nz_TFP*nQ.
+/// Expectations keep the two transition matrices separate (see @link
+/// kronExp @endlink).
+///
+/// @details Usage: `./shocks2 [rhoQ sigmaQ nQ]' (default 0.9 0.01 3). The
+/// value and policy functions are written to `valFun2CPP.dat' and
+/// `polFun2CPP.dat' in the format of `main' (column j = j1 + nz_TFP*j2 for
+/// TFP state j1 and investment shock state j2), and `solTime2CPP.dat'
+/// holds the solution time, the number of iterations, the time of one
+/// expectation stage with the separate factors and with the dense
+/// Kronecker product, and the largest difference between the two.
+///
+/// @returns 0 upon successful completion, 1 otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+
+  // admin
+  int i, j;
+  double tic = curr_second(); // Start time
+
+  // Load parameters
+  parameters params;
+  params.load("../parameters.txt");
+  parameters paramQ = params;
+  paramQ.mu = 0.0;
+  paramQ.rho = argc > 3 ? atof(argv[1]) : 0.9;
+  paramQ.sigma = argc > 3 ? atof(argv[2]) : 0.01;
+  paramQ.nz = argc > 3 ? atoi(argv[3]) : 3;
+  if(paramQ.nz < 2){
+    cerr << "The investment shock needs at least 2 states" << endl;
+    return 1;
+  }
+  const int nk = params.nk;
+  const int n1 = params.nz;
+  const int n2 = paramQ.nz;
+  const int nz = n1*n2;
+
+  // shock grids and joint productivity of capital z*q
+  VectorXR Z(n1), Q(n2);
+  MatrixXR P1(n1, n1), P2(n2, n2);
+  ar1(params, Z, P1);
+  ar1(paramQ, Q, P2);
+  VectorXR ZQ(nz);
+  for(j = 0 ; j < nz ; ++j) ZQ(j) = Z(j%n1)*Q(j/n1);
+
+  // capital grid spans the steady states at the lowest and highest z*q
+  parameters paramK = params;
+  paramK.nz = 2;
+  VectorXR ZQb(2);
+  ZQb << ZQ.minCoeff(), ZQ.maxCoeff();
+  VectorXR K(nk);
+  kGrid(paramK, ZQb, K);
+
+  // initial VF and iteration
+  parameters paramJ = params;
+  paramJ.nz = nz;
+  MatrixXR V0(nk, nz), V(nk, nz);
+  MatrixXi G(nk, nz);
+  vfInit(paramJ, ZQ, V0);
+  REAL diff = 1.0;
+  int iter = 0;
+  while(fabs(diff) > params.tol){
+    vfStep2(paramJ, K, Z, Q, P1, P2, V0, V, G);
+    diff = (V-V0).array().abs().maxCoeff();
+    V0 = V;
+    ++iter;
+  }
+  double solTime = curr_second() - tic;
+
+  // expectation stage with separate factors and with the dense product
+  const int nRep = 20;
+  MatrixXR EVk, EVd, Pj(nz, nz);
+  for(j = 0 ; j < nz ; ++j){
+    for(int l = 0 ; l < nz ; ++l) Pj(j,l) = P1(j%n1,l%n1)*P2(j/n1,l/n1);
+  }
+  tic = curr_second();
+  for(int rep = 0 ; rep < nRep ; ++rep) kronExp(V, P1, P2, EVk);
+  double kronTime = (curr_second() - tic)/nRep;
+  tic = curr_second();
+  for(int rep = 0 ; rep < nRep ; ++rep) EVd.noalias() = V*Pj.transpose();
+  double denseTime = (curr_second() - tic)/nRep;
+  REAL expDiff = (EVk-EVd).array().abs().maxCoeff();
+
+  // write to file (column major)
+  ofstream fileSolTime, fileValue, filePolicy;
+  fileValue.precision(10);
+  filePolicy.precision(10);
+  fileSolTime.open("solTime2CPP.dat");
+  fileValue.open("valFun2CPP.dat");
+  filePolicy.open("polFun2CPP.dat");
+  fileSolTime << solTime << endl;
+  fileSolTime << iter << endl;
+  fileSolTime << kronTime << endl;
+  fileSolTime << denseTime << endl;
+  fileSolTime << expDiff << endl;
+  fileValue << nk << endl;
+  fileValue << nz << endl;
+  filePolicy << nk << endl;
+  filePolicy << nz << endl;
+  for(j = 0 ; j < nz ; ++j){
+    for(i = 0 ; i < nk ; ++i){
+      fileValue << V(i,j) << endl;
+      filePolicy << G(i,j) << endl;
+    }
+  }
+  fileSolTime.close();
+  fileValue.close();
+  filePolicy.close();
+
+  return 0;
+
+}
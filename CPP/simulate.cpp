@@ -0,0 +1,126 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file simulate.cpp
+///
+/// @brief File containing Monte Carlo simulation function for the solved
+/// policy.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to simulate a panel of economies under the policy.
+///
+/// @details This function simulates nAgents independent economies for
+/// nBurn+nPeriods periods, starting from the middle of the capital and TFP
+/// grids. TFP indices are drawn from P with @link cbrng @endlink, using
+/// one stream per economy and the period as counter. Capital either stays
+/// on the grid, following G directly, or is continuous and follows the
+/// policy interpolated by @link polInterp @endlink. Moments of capital,
+/// output, consumption and investment are accumulated after the burn-in
+/// period without storing the paths. Economies are simulated in parallel;
+/// since partial sums are stored per economy and added in a fixed order,
+/// results do not depend on the number of threads.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] K Grid of capital values.
+/// @param [in] Z Grid of TFP values.
+/// @param [in] P TFP transition matrix.
+/// @param [in] G Matrix storing policy function.
+/// @param [in] nAgents Number of simulated economies.
+/// @param [in] nPeriods Number of periods used to compute moments.
+/// @param [in] nBurn Number of initial periods which are discarded.
+/// @param [in] seed Seed of the random number generator.
+/// @param [in] interp Whether capital follows the interpolated policy.
+/// @param [out] stats Simulated moments.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void simulate(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	      const MatrixXR& P, const MatrixXi& G, const int& nAgents,
+	      const int& nPeriods, const int& nBurn,
+	      const unsigned long long& seed, const bool& interp,
+	      simStats& stats)
+{
+
+  // basic parameters
+  const int nk = param.nk;
+  const int nz = param.nz;
+  const REAL alpha = param.alpha;
+  const REAL delta = param.delta;
+
+  // cumulative transition probabilities and output per unit of TFP
+  MatrixXR Pc(nz, nz);
+  Pc.col(0) = P.col(0);
+  for(int l = 1 ; l < nz ; ++l) Pc.col(l) = Pc.col(l-1) + P.col(l);
+  const VectorXR Kalpha = K.array().pow(alpha).matrix();
+
+  // per economy sums of k, y, c, i, their squares and y(t)*y(t-1)
+  const int nMom = 9;
+  MatrixXR sums = MatrixXR::Zero(nMom, nAgents);
+
+#pragma omp parallel for schedule(static)
+  for(int a = 0 ; a < nAgents ; ++a){
+    int i = nk/2, g, j = nz/2;
+    REAL k = K(i), kp, y, c, inv, yLag = 0.0;
+    REAL s[nMom] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+    for(int t = 0 ; t < nBurn+nPeriods ; ++t){
+      if(interp){
+	kp = polInterp(k, j, K, G);
+	y = Z(j)*pow(k,alpha);
+      } else {
+	g = G(i,j);
+	k = K(i);
+	kp = K(g);
+	y = Z(j)*Kalpha(i);
+	i = g;
+      }
+      inv = kp - (1-delta)*k;
+      c = y - inv;
+      if(t >= nBurn){
+	s[0] += k; s[1] += k*k;
+	s[2] += y; s[3] += y*y;
+	s[4] += c; s[5] += c*c;
+	s[6] += inv; s[7] += inv*inv;
+	if(t > nBurn) s[8] += y*yLag;
+      }
+      yLag = y;
+      k = kp;
+      j = zDraw(cbrng(seed, a, t), j, Pc);
+    }
+    for(int m = 0 ; m < nMom ; ++m) sums(m,a) = s[m];
+  }
+
+  // combine economies in a fixed order
+  const VectorXR tot = sums.rowwise().sum();
+  const REAL n = (REAL)nAgents*nPeriods;
+  stats.meanK = tot(0)/n;
+  stats.sdK = sqrt(tot(1)/n - stats.meanK*stats.meanK);
+  stats.meanY = tot(2)/n;
+  stats.sdY = sqrt(tot(3)/n - stats.meanY*stats.meanY);
+  stats.meanC = tot(4)/n;
+  stats.sdC = sqrt(tot(5)/n - stats.meanC*stats.meanC);
+  stats.meanI = tot(6)/n;
+  stats.sdI = sqrt(tot(7)/n - stats.meanI*stats.meanI);
+  stats.acY = (tot(8)/((REAL)nAgents*(nPeriods-1)) - stats.meanY*stats.meanY)
+    /(stats.sdY*stats.sdY);
+}
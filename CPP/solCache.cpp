@@ -0,0 +1,254 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file solCache.cpp
+///
+/// @brief File containing functions for a content-addressed on-disk cache
+/// of solutions.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+using namespace std;
+using namespace Eigen;
+
+/// Description of the solution method, included in the hash so that
+/// solutions of different engines, grids or precisions never collide.
+static const char engineTag[] = "CPP vfStep/binaryMax, linear K grid, AR1 Z";
+
+/// Number of parameter values stored in each cache file.
+static const int nParam = 15;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @class cacheHeader
+///
+/// @brief Header of a cache file, followed by V (REAL) and G (int).
+///
+//////////////////////////////////////////////////////////////////////////////
+class cacheHeader{
+ public:
+  char magic[8]; ///< File identifier ("VFICACHE").
+  unsigned long long hash; ///< Hash of the calibration and method.
+  int realSize; ///< sizeof(REAL) of the stored value function.
+  int nk; ///< Number of values in capital grid.
+  int nz; ///< Number of values in TFP grid.
+  int pad; ///< Unused.
+  REAL param[nParam]; ///< Parameter values (to guard against collisions).
+};
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to list the parameter values of a calibration.
+///
+/// @param [in] p Object of class parameters.
+/// @param [out] v Parameter values, in the order of the class members.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+static void paramArray(const parameters& p, REAL* v)
+{
+  v[0] = p.eta; v[1] = p.beta; v[2] = p.alpha; v[3] = p.delta; v[4] = p.mu;
+  v[5] = p.rho; v[6] = p.sigma; v[7] = p.lambda; v[8] = p.nk; v[9] = p.nz;
+  v[10] = p.tol; v[11] = p.zMethod; v[12] = p.pTol;
+  v[13] = p.gamma; v[14] = p.guard;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to hash a calibration and solution method.
+///
+/// @details This function computes the 64-bit FNV-1a hash of the bytes of
+/// all parameter values, the size of REAL and a description of the
+/// solution method.
+///
+/// @param [in] param Object of class parameters.
+///
+/// @returns Hash value.
+///
+//////////////////////////////////////////////////////////////////////////////
+unsigned long long solHash(const parameters& param)
+{
+  REAL v[nParam];
+  paramArray(param, v);
+  const int realSize = sizeof(REAL);
+  unsigned long long h = 0xCBF29CE484222325ULL;
+  const unsigned char* b = (const unsigned char*)v;
+  for(size_t ix = 0 ; ix < sizeof(v) ; ++ix) h = (h ^ b[ix])*0x100000001B3ULL;
+  b = (const unsigned char*)&realSize;
+  for(size_t ix = 0 ; ix < sizeof(int) ; ++ix) h = (h ^ b[ix])*0x100000001B3ULL;
+  for(size_t ix = 0 ; ix < sizeof(engineTag) ; ++ix){
+    h = (h ^ (unsigned char)engineTag[ix])*0x100000001B3ULL;
+  }
+  return h;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to form the name of a cache file.
+///
+/// @param [in] dir Cache directory.
+/// @param [in] hash Hash of the calibration.
+///
+/// @returns File name.
+///
+//////////////////////////////////////////////////////////////////////////////
+static string cacheFile(const char* dir, const unsigned long long& hash)
+{
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.bin", hash);
+  return string(dir) + "/" + name;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to look up a solution in the cache.
+///
+/// @details This function memory maps the cache file named by the hash of
+/// the calibration (see @link solHash @endlink) and, if its header matches
+/// the calibration exactly, copies the stored value and policy functions.
+/// The modification time of the file is updated on a hit, so that it
+/// records the last use for eviction by @link cacheStore @endlink.
+///
+/// @param [in] dir Cache directory.
+/// @param [in] param Object of class parameters.
+/// @param [out] V Cached value function (nk x nz, sized by the caller).
+/// @param [out] G Cached policy function (nk x nz, sized by the caller).
+///
+/// @returns true on a cache hit, false otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+bool cacheLoad(const char* dir, const parameters& param, Ref<MatrixXR> V,
+	       Ref<MatrixXi> G)
+{
+  const unsigned long long hash = solHash(param);
+  const string name = cacheFile(dir, hash);
+  const int fd = open(name.c_str(), O_RDONLY);
+  if(fd < 0) return false;
+  struct stat st;
+  const size_t nb = (size_t)param.nk*param.nz;
+  const size_t size = sizeof(cacheHeader) + nb*(sizeof(REAL)+sizeof(int));
+  if(fstat(fd, &st) != 0 || (size_t)st.st_size != size){
+    close(fd);
+    return false;
+  }
+  void* addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(addr == MAP_FAILED) return false;
+
+  // validate the header
+  const cacheHeader* h = (const cacheHeader*)addr;
+  REAL v[nParam];
+  paramArray(param, v);
+  bool hit = memcmp(h->magic, "VFICACHE", 8) == 0 && h->hash == hash &&
+    h->realSize == (int)sizeof(REAL) && h->nk == param.nk &&
+    h->nz == param.nz && memcmp(h->param, v, sizeof(v)) == 0;
+  if(hit){
+    const char* data = (const char*)addr + sizeof(cacheHeader);
+    memcpy(V.data(), data, nb*sizeof(REAL));
+    memcpy(G.data(), data + nb*sizeof(REAL), nb*sizeof(int));
+    utimes(name.c_str(), NULL);
+  }
+  munmap(addr, size);
+  return hit;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to store a solution in the cache.
+///
+/// @details This function writes the solution to a temporary file in the
+/// cache directory and renames it to the name given by the hash of the
+/// calibration, so that concurrent readers never see a partial file. The
+/// least recently used files (by modification time) are then removed until
+/// the total size of the cache is within the budget.
+///
+/// @param [in] dir Cache directory.
+/// @param [in] param Object of class parameters.
+/// @param [in] V Value function.
+/// @param [in] G Policy function.
+/// @param [in] budget Maximum total size of the cache in bytes.
+///
+/// @returns true upon success, false otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+bool cacheStore(const char* dir, const parameters& param,
+		const Ref<const MatrixXR>& V, const Ref<const MatrixXi>& G,
+		const size_t& budget)
+{
+  // write the solution
+  cacheHeader h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, "VFICACHE", 8);
+  h.hash = solHash(param);
+  h.realSize = sizeof(REAL);
+  h.nk = param.nk;
+  h.nz = param.nz;
+  paramArray(param, h.param);
+  const string name = cacheFile(dir, h.hash);
+  char suffix[32];
+  snprintf(suffix, sizeof(suffix), ".tmp%d", (int)getpid());
+  const string tmp = name + suffix;
+  FILE* f = fopen(tmp.c_str(), "wb");
+  if(f == NULL) return false;
+  const size_t nb = (size_t)param.nk*param.nz;
+  bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+    fwrite(V.data(), sizeof(REAL), nb, f) == nb &&
+    fwrite(G.data(), sizeof(int), nb, f) == nb;
+  ok = (fclose(f) == 0) && ok;
+  if(!ok || rename(tmp.c_str(), name.c_str()) != 0){
+    unlink(tmp.c_str());
+    return false;
+  }
+
+  // evict least recently used files beyond the budget
+  DIR* d = opendir(dir);
+  if(d == NULL) return true;
+  vector< pair<double, pair<off_t, string> > > files;
+  size_t total = 0;
+  struct dirent* e;
+  struct stat st;
+  while((e = readdir(d)) != NULL){
+    const string fn = e->d_name;
+    if(fn.size() != 20 || fn.compare(16, 4, ".bin") != 0) continue;
+    const string path = string(dir) + "/" + fn;
+    if(stat(path.c_str(), &st) != 0) continue;
+    files.push_back(make_pair(st.st_mtim.tv_sec + 1e-9*st.st_mtim.tv_nsec,
+			       make_pair(st.st_size, path)));
+    total += st.st_size;
+  }
+  closedir(d);
+  sort(files.begin(), files.end());
+  for(size_t ix = 0 ; ix < files.size() && total > budget ; ++ix){
+    if(files[ix].second.second == name) continue;
+    if(unlink(files[ix].second.second.c_str()) == 0){
+      total -= files[ix].second.first;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,122 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file solver.cpp
+///
+/// @brief File containing methods of the embeddable solver class.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "solver.h"
+#include <string.h>
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Solver constructor.
+///
+/// @details Computes the TFP and capital grids of the calibration and
+/// allocates the workspaces.
+///
+/// @param [in] param Object of class parameters.
+///
+//////////////////////////////////////////////////////////////////////////////
+Solver::Solver(const parameters& param)
+  : solved_(false)
+{
+  setParameters(param);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to change the calibration of a Solver.
+///
+/// @details Recomputes the grids (only those whose parameters changed) and
+/// resizes the workspaces. The latest solution is kept as a warm start for
+/// the next call to solve().
+///
+/// @param [in] param Object of class parameters.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void Solver::setParameters(const parameters& param)
+{
+  const bool first = K_.size() == 0;
+  const bool sameZ = !first && param.mu == param_.mu &&
+    param.rho == param_.rho && param.sigma == param_.sigma &&
+    param.lambda == param_.lambda && param.nz == param_.nz &&
+    param.zMethod == param_.zMethod;
+  const bool sameK = sameZ && param.alpha == param_.alpha &&
+    param.beta == param_.beta && param.delta == param_.delta &&
+    param.nk == param_.nk;
+  param_ = param;
+  if(!sameZ){
+    Z_.resize(param.nz);
+    P_.resize(param.nz, param.nz);
+    ar1(param_, Z_, P_);
+  }
+  if(!sameK){
+    K_.resize(param.nk);
+    kGrid(param_, Z_, K_);
+  }
+  V0_.resize(param.nk, param.nz);
+  V_.resize(param.nk, param.nz);
+  G_.resize(param.nk, param.nz);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to solve the current calibration.
+///
+/// @details Iterates the value function to convergence starting from, in
+/// order of preference, the caller's initial value function opt.V0, the
+/// previous solution (if opt.warm is set and one exists) or the
+/// steady-state guess of @link vfInit @endlink. If opt.V or opt.G are not
+/// NULL, the solution is copied into them; otherwise it can be read in
+/// place through value() and policy().
+///
+/// @param [in] opt Object of class solveOptions.
+///
+/// @returns Number of iterations performed.
+///
+//////////////////////////////////////////////////////////////////////////////
+int Solver::solve(const solveOptions& opt)
+{
+  const int nk = param_.nk;
+  const int nz = param_.nz;
+  int iter;
+  if(opt.V0 != NULL){
+    V0_ = Map<const MatrixXR>(opt.V0, nk, nz);
+    iter = vfSolve(param_, K_, Z_, P_, V0_, V_, G_, opt.progress, opt.data);
+  } else if(opt.warm && solved_){
+    iter = vfSolveWarm(param_, K_, Z_, P_, betaPrev_, Kprev_, Zprev_, Vprev_,
+		       V0_, V_, G_, opt.progress, opt.data);
+  } else {
+    vfInit(param_, Z_, V0_);
+    iter = vfSolve(param_, K_, Z_, P_, V0_, V_, G_, opt.progress, opt.data);
+  }
+
+  // keep the solution as a warm start for the next solve
+  solved_ = true;
+  betaPrev_ = param_.beta;
+  Kprev_ = K_;
+  Zprev_ = Z_;
+  Vprev_ = V_;
+  if(opt.V != NULL) memcpy(opt.V, V_.data(), sizeof(REAL)*nk*nz);
+  if(opt.G != NULL) memcpy(opt.G, G_.data(), sizeof(int)*nk*nz);
+  return iter;
+}
@@ -0,0 +1,86 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file solver.h
+///
+/// @brief Header file for the embeddable solver class.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef __FILE_SOLVER_H_SEEN__
+#define __FILE_SOLVER_H_SEEN__
+
+#include "global.h"
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @class solveOptions
+///
+/// @brief Object to store options for a call to Solver::solve.
+///
+//////////////////////////////////////////////////////////////////////////////
+class solveOptions{
+ public:
+  REAL* V; ///< Caller-owned buffer for the value function (nk*nz, column major), or NULL.
+  int* G; ///< Caller-owned buffer for the policy function (nk*nz, column major), or NULL.
+  const REAL* V0; ///< Initial value function (nk*nz, column major), or NULL.
+  bool warm; ///< Warm start from the previous solution if V0 is NULL.
+  vfProgress progress; ///< Progress callback, or NULL.
+  void* data; ///< User data passed to the progress callback.
+  solveOptions() : V(NULL), G(NULL), V0(NULL), warm(true), progress(NULL),
+    data(NULL) {}
+};
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @class Solver
+///
+/// @brief Reusable value function iteration solver.
+///
+/// @details A Solver holds the grids, workspaces and latest solution for a
+/// calibration, so that it can be solved repeatedly in-process, e.g.
+/// within an estimation loop. Changing the calibration with
+/// setParameters() keeps the latest solution, from which the next solve is
+/// warm started (see @link vfSolveWarm @endlink). Solutions can be copied
+/// into caller-owned buffers or accessed in place through value() and
+/// policy(), which remain valid until the next call to solve().
+///
+//////////////////////////////////////////////////////////////////////////////
+class Solver{
+ public:
+  Solver(const parameters& param);
+  void setParameters(const parameters& param);
+  int solve(const solveOptions& opt = solveOptions());
+  const parameters& params() const {return param_;} ///< Calibration.
+  const VectorXR& K() const {return K_;} ///< Grid of capital values.
+  const VectorXR& Z() const {return Z_;} ///< Grid of TFP values.
+  const MatrixXR& P() const {return P_;} ///< TFP transition matrix.
+  const MatrixXR& value() const {return V_;} ///< Latest value function.
+  const MatrixXi& policy() const {return G_;} ///< Latest policy function.
+ private:
+  parameters param_; ///< Calibration.
+  VectorXR K_; ///< Grid of capital values.
+  VectorXR Z_; ///< Grid of TFP values.
+  MatrixXR P_; ///< TFP transition matrix.
+  MatrixXR V0_; ///< Workspace for the initial value function.
+  MatrixXR V_; ///< Latest value function.
+  MatrixXi G_; ///< Latest policy function.
+  bool solved_; ///< Whether a solution has been computed.
+  REAL betaPrev_; ///< Time discount factor of the latest solution.
+  VectorXR Kprev_; ///< Capital grid of the latest solution.
+  VectorXR Zprev_; ///< TFP grid of the latest solution.
+  MatrixXR Vprev_; ///< Latest solution (kept across setParameters()).
+};
+
+#endif
@@ -0,0 +1,56 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file spMV.cpp
+///
+/// @brief File containing parallel sparse matrix-vector product.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute a sparse matrix-vector product in parallel.
+///
+/// @details This function computes y = A*x for a compressed row storage
+/// matrix A. Rows are distributed across OpenMP threads; since each thread
+/// only writes its own elements of y, no synchronization is required.
+///
+/// @param [in] A Sparse matrix (row major).
+/// @param [in] x Vector to multiply.
+/// @param [out] y Product A*x.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void spMV(const SpMatR& A, const VectorXR& x, VectorXR& y)
+{
+  const int n = A.rows();
+  const int* outer = A.outerIndexPtr();
+  const int* inner = A.innerIndexPtr();
+  const REAL* val = A.valuePtr();
+  y.resize(n);
+
+#pragma omp parallel for schedule(static)
+  for(int r = 0 ; r < n ; ++r){
+    REAL s = 0.0;
+    for(int e = outer[r] ; e < outer[r+1] ; ++e) s += val[e]*x(inner[e]);
+    y(r) = s;
+  }
+}
@@ -0,0 +1,94 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file statDist.cpp
+///
+/// @brief File containing function to compute the stationary distribution
+/// over the state space.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute the stationary distribution of a transition
+/// operator.
+///
+/// @details This function iterates mu' = T*mu to a fixed point, using the
+/// parallel sparse product @link spMV @endlink. If mAnderson > 0, the
+/// iteration is accelerated with Anderson mixing over the last mAnderson
+/// iterates; the mixed iterate is projected back onto the simplex
+/// (negative mass is set to zero and the total is renormalized).
+/// Convergence is declared when the maximum absolute change in mu is below
+/// tol.
+///
+/// @param [in] T Sparse transition operator, as built by @link transOp
+/// @endlink.
+/// @param [in] mAnderson Anderson acceleration depth (0 for plain iteration).
+/// @param [in] tol Tolerance for convergence.
+/// @param [in] maxIter Maximum number of iterations.
+/// @param [in,out] mu Initial guess (uniform if empty) and stationary
+/// distribution.
+///
+/// @returns Number of iterations performed.
+///
+//////////////////////////////////////////////////////////////////////////////
+int statDist(const SpMatR& T, const int& mAnderson, const REAL& tol,
+	     const int& maxIter, VectorXR& mu)
+{
+  const int n = T.rows();
+  if(mu.size() != n) mu = VectorXR::Constant(n, 1.0/n);
+
+  // Anderson history: differences of images and residuals
+  const int m = mAnderson;
+  MatrixXR dGx(n, m), dF(n, m);
+  VectorXR gx(n), f(n), gxOld, fOld, gamma;
+  int nHist = 0, col = 0;
+
+  int iter = 0;
+  REAL diff = 1.0;
+  while(diff > tol && iter < maxIter){
+    spMV(T, mu, gx);
+    f = gx - mu;
+    diff = f.array().abs().maxCoeff();
+    if(m == 0){
+      mu = gx;
+    } else {
+      if(iter > 0){
+	dGx.col(col) = gx - gxOld;
+	dF.col(col) = f - fOld;
+	col = (col+1)%m;
+	if(nHist < m) ++nHist;
+      }
+      gxOld = gx;
+      fOld = f;
+      if(nHist == 0){
+	mu = gx;
+      } else {
+	gamma = (dF.leftCols(nHist).transpose()*dF.leftCols(nHist)).ldlt()
+	  .solve(dF.leftCols(nHist).transpose()*f);
+	mu = gx - dGx.leftCols(nHist)*gamma;
+	mu = mu.cwiseMax(0.0);
+	mu /= mu.sum();
+      }
+    }
+    ++iter;
+  }
+  return iter;
+}
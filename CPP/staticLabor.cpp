@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file staticLabor.cpp
+///
+/// @brief File containing function to solve the intratemporal labor choice.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to solve the intratemporal labor choice.
+///
+/// @details Given capital, TFP and future capital, consumption is
+/// c = A*l^(1-alpha) + B, with A = z*k^alpha and B = (1-delta)*k - k', and
+/// labor l in (0,1] maximizes c^(1-eta)/(1-eta) - psi*l^(1+1/frisch)/
+/// (1+1/frisch). With x = log(l), the first order condition
+///
+///   g(x) = log((1-alpha)*A/psi) - (alpha+1/frisch)*x - eta*log(c) = 0
+///
+/// has a strictly decreasing left side, so that its root is unique. If
+/// g(0) >= 0 the time endowment binds and l = 1. Otherwise the root is
+/// bracketed between 0 and the value of x at which consumption vanishes (or
+/// a point found by doubling if B >= 0) and found by Newton's method,
+/// falling back to bisection when a step leaves the bracket. Since labor
+/// varies smoothly with k', the solution at a neighbouring k' is a good
+/// starting value.
+///
+/// @param [in] A Output per unit of labor^(1-alpha), z*k^alpha.
+/// @param [in] B Depreciated capital net of future capital, (1-delta)*k-k'.
+/// @param [in] alpha Capital share.
+/// @param [in] eta Coefficient of relative risk aversion.
+/// @param [in] frisch Frisch elasticity of labor supply.
+/// @param [in] psi Weight of the disutility of labor.
+/// @param [in,out] x Starting value for log labor (ignored if outside the
+/// bracket); the solution on output.
+///
+/// @returns Optimal labor.
+///
+//////////////////////////////////////////////////////////////////////////////
+REAL staticLabor(const REAL& A, const REAL& B, const REAL& alpha,
+		 const REAL& eta, const REAL& frisch, const REAL& psi, REAL& x)
+{
+  const REAL a = log((1-alpha)*A/psi);
+  const REAL e = alpha + 1/frisch;
+
+  // corner: full time endowment
+  REAL c = A + B;
+  if(a - eta*log(c) >= 0){
+    x = 0.0;
+    return 1.0;
+  }
+
+  // bracket the root
+  REAL lo, hi = 0.0;
+  if(B < 0){
+    lo = log(-B/A)/(1-alpha);
+  } else {
+    lo = -1.0;
+    while(a - e*lo - eta*log(A*exp((1-alpha)*lo) + B) <= 0) lo *= 2;
+  }
+  if(!(x > lo && x < hi)) x = 0.5*(lo+hi);
+
+  // safeguarded Newton iterations
+  REAL y, g, dg;
+  for(int it = 0 ; it < 100 ; ++it){
+    y = A*exp((1-alpha)*x);
+    c = y + B;
+    g = a - e*x - eta*log(c);
+    if(fabs(g) < 1e-13) break;
+    if(g > 0) lo = x; else hi = x;
+    dg = -e - eta*(1-alpha)*y/c;
+    x -= g/dg;
+    if(!(x > lo && x < hi)) x = 0.5*(lo+hi);
+    if(hi-lo < 1e-15) break;
+  }
+  return exp(x);
+}
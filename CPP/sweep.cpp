@@ -0,0 +1,428 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file sweep.cpp
+///
+/// @brief File containing main function for a batched parameter sweep.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <omp.h>
+
+using namespace std;
+using namespace Eigen;
+
+/// Number of parameter values stored in each record of the output index.
+static const int nParam = 15;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to list the parameter values of a calibration.
+///
+/// @param [in] p Object of class parameters.
+///
+/// @returns Vector of parameter values, in the order of the class members.
+///
+//////////////////////////////////////////////////////////////////////////////
+static vector<REAL> paramVec(const parameters& p)
+{
+  REAL v[nParam] = {p.eta, p.beta, p.alpha, p.delta, p.mu, p.rho, p.sigma,
+		    p.lambda, (REAL)p.nk, (REAL)p.nz, p.tol, (REAL)p.zMethod,
+		    p.pTol, p.gamma, (REAL)p.guard};
+  return vector<REAL>(v, v+nParam);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to load a table of calibrations.
+///
+/// @details The first line of the table is a comma separated list of
+/// parameter names (as in the parameters class), and each subsequent line
+/// is a comma separated list of the corresponding values. Parameters which
+/// are not listed keep their values from the base calibration.
+///
+/// @param [in] fileName Name of file storing the table.
+/// @param [in] base Base calibration.
+/// @param [out] calib Vector of calibrations, one per row of the table.
+///
+/// @returns true upon success, false otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+static bool loadTable(const char* fileName, const parameters& base,
+		      vector<parameters>& calib)
+{
+  ifstream fileIn(fileName);
+  if(!fileIn) return false;
+  string line, field;
+  vector<string> names;
+  getline(fileIn, line);
+  stringstream header(line);
+  while(getline(header, field, ',')){
+    field.erase(0, field.find_first_not_of(" \t\r"));
+    field.erase(field.find_last_not_of(" \t\r")+1);
+    names.push_back(field);
+  }
+  while(getline(fileIn, line)){
+    if(line.find_first_not_of(" \t\r") == string::npos) continue;
+    stringstream row(line);
+    parameters p = base;
+    for(size_t ix = 0 ; ix < names.size() ; ++ix){
+      if(!getline(row, field, ',')) return false;
+      if(!p.set(names[ix], atof(field.c_str()))){
+	cerr << "Unknown parameter: " << names[ix] << endl;
+	return false;
+      }
+    }
+    calib.push_back(p);
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute the distance between two calibrations.
+///
+/// @param [in] a Parameter values of the first calibration.
+/// @param [in] b Parameter values of the second calibration.
+/// @param [in] range Range of each parameter across the sweep (parameters
+/// with zero range are ignored).
+///
+/// @returns Euclidean distance between the normalized parameter values.
+///
+//////////////////////////////////////////////////////////////////////////////
+static REAL paramDist(const vector<REAL>& a, const vector<REAL>& b,
+		      const vector<REAL>& range)
+{
+  REAL d = 0.0;
+  for(int ix = 0 ; ix < nParam ; ++ix){
+    if(range[ix] > 0) d += pow((a[ix]-b[ix])/range[ix], 2);
+  }
+  return sqrt(d);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to order calibrations along a nearest-neighbour path.
+///
+/// @details Starting from the first calibration, the path repeatedly moves
+/// to the closest calibration (see @link paramDist @endlink) which has not
+/// been visited, so that consecutive solves are similar problems.
+///
+/// @param [in] pv Parameter values of each calibration.
+/// @param [in] range Range of each parameter across the sweep.
+/// @param [out] order Calibration indices in path order.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+static void pathOrder(const vector< vector<REAL> >& pv,
+		      const vector<REAL>& range, vector<int>& order)
+{
+  const int n = pv.size();
+  vector<bool> visited(n, false);
+  order.assign(n, 0);
+  int cur = 0;
+  REAL d, dmin;
+  for(int q = 0 ; q < n ; ++q){
+    order[q] = cur;
+    visited[cur] = true;
+    int next = -1;
+    dmin = HUGE_VAL;
+    for(int s = 0 ; s < n ; ++s){
+      if(visited[s]) continue;
+      d = paramDist(pv[cur], pv[s], range);
+      if(d < dmin){dmin = d; next = s;}
+    }
+    cur = next;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @fn main()
+///
+/// @brief Main function for a batched parameter sweep.
+///
+/// @details This function solves the growth model for every calibration in
+/// a parameter table (see @link loadTable @endlink), with parameters not in
+/// the table taken from `../parameters.txt'. TFP grids and transition
+/// matrices are computed once for each distinct (mu, rho, sigma, lambda,
+/// nz), and capital grids once for each distinct combination of those with
+/// (alpha, beta, delta, nk); calibrations share them. Solves are then
+/// distributed dynamically across OpenMP threads, each of which reuses its
+/// own value and policy function workspaces from one solve to the next.
+///
+/// @details Calibrations are scheduled along a nearest-neighbour path
+/// through (normalized) parameter space, see @link pathOrder @endlink.
+/// Each solve is warm started from the closest calibration with the same
+/// TFP discretization and preferences (the same eta, and Epstein-Zin
+/// utility in both or neither) at least nThread positions earlier on the
+/// path (where nThread is the number of OpenMP threads), waiting for it to
+/// finish if necessary, so that the source does not depend on the timing
+/// of the threads. (A value function for a different eta may have the
+/// wrong sign for the certainty equivalents of @link ezExp @endlink.) The
+/// source is read back from the output file and interpolated onto the new
+/// grids by @link vfSolveWarm @endlink; calibrations without a source
+/// start from the steady-state guess. Warm starts can be disabled with the
+/// `-cold' flag. With the `-bench' flag, each warm started calibration is
+/// also solved from the steady-state guess (outside the timed solve), to
+/// measure the number of iterations saved.
+///
+/// @details Results are written to a single binary file, as they complete,
+/// with the layout
+///   - number of solves and number of parameters per record (32-bit ints);
+///   - an index with one record per solve of 21 REAL values: the 15
+///     parameter values (as in the parameters class), the number of
+///     iterations, the solution time, the byte offsets of the value and
+///     policy functions in the file, the index of the solve used as a
+///     warm start (-1 if none) and the number of iterations saved by the
+///     warm start (measured with `-bench', 0 otherwise);
+///   - the value functions of all solves (REAL, column major), followed by
+///     the policy functions of all solves (32-bit int, column major).
+///
+/// @details Usage: `./sweep [-cold | -bench] table [output]', where output
+/// defaults to `sweepCPP.bin'. The total time, the throughput in solves
+/// per hour and the mean number of iterations saved per solve are written
+/// to `sweepTimeCPP.dat'.
+///
+/// @returns 0 upon successful completion, 1 otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+  int arg = 1;
+  bool warm = true, bench = false;
+  if(argc > 1 && string(argv[1]) == "-cold"){
+    warm = false;
+    ++arg;
+  } else if(argc > 1 && string(argv[1]) == "-bench"){
+    bench = true;
+    ++arg;
+  }
+  if(argc < arg+1){
+    cerr << "Usage: " << argv[0] << " [-cold | -bench] table [output]"
+	 << endl;
+    return 1;
+  }
+  const char* tableName = argv[arg];
+  const char* outName = argc > arg+1 ? argv[arg+1] : "sweepCPP.bin";
+  double tic = curr_second();
+
+  // Load base parameters and calibrations
+  parameters base;
+  base.load("../parameters.txt");
+  vector<parameters> calib;
+  if(!loadTable(tableName, base, calib)){
+    cerr << "Could not read parameter table " << tableName << endl;
+    return 1;
+  }
+  const int nSolve = calib.size();
+
+  // compute TFP and capital grids shared across calibrations
+  map<vector<REAL>, int> zKeys, kKeys;
+  vector<VectorXR> Zs, Ks;
+  vector<MatrixXR> Ps;
+  vector<int> zIx(nSolve), kIx(nSolve);
+  for(int s = 0 ; s < nSolve ; ++s){
+    const parameters& p = calib[s];
+    REAL zk[] = {p.mu, p.rho, p.sigma, p.lambda, (REAL)p.nz, (REAL)p.zMethod};
+    vector<REAL> zKey(zk, zk+6);
+    map<vector<REAL>, int>::iterator it = zKeys.find(zKey);
+    if(it == zKeys.end()){
+      Zs.push_back(VectorXR(p.nz));
+      Ps.push_back(MatrixXR(p.nz, p.nz));
+      ar1(p, Zs.back(), Ps.back());
+      it = zKeys.insert(make_pair(zKey, (int)Zs.size()-1)).first;
+    }
+    zIx[s] = it->second;
+    vector<REAL> kKey = zKey;
+    kKey.push_back(p.alpha);
+    kKey.push_back(p.beta);
+    kKey.push_back(p.delta);
+    kKey.push_back(p.nk);
+    it = kKeys.find(kKey);
+    if(it == kKeys.end()){
+      Ks.push_back(VectorXR(p.nk));
+      kGrid(p, Zs[zIx[s]], Ks.back());
+      it = kKeys.insert(make_pair(kKey, (int)Ks.size()-1)).first;
+    }
+    kIx[s] = it->second;
+  }
+
+  // order calibrations along a path through parameter space
+  vector< vector<REAL> > pv(nSolve);
+  for(int s = 0 ; s < nSolve ; ++s) pv[s] = paramVec(calib[s]);
+  vector<REAL> range(nParam, 0.0);
+  for(int ix = 0 ; ix < nParam ; ++ix){
+    REAL lo = HUGE_VAL, hi = -HUGE_VAL;
+    for(int s = 0 ; s < nSolve ; ++s){
+      lo = pv[s][ix] < lo ? pv[s][ix] : lo;
+      hi = pv[s][ix] > hi ? pv[s][ix] : hi;
+    }
+    range[ix] = hi-lo;
+  }
+  vector<int> order;
+  pathOrder(pv, range, order);
+
+  // warm start sources: the closest calibration with the same
+  // discretization and preferences (eta, and whether utility is
+  // Epstein-Zin) at least nLag positions earlier on the path, all of which
+  // have been handed to a thread before the solve itself
+  const int nLag = omp_get_max_threads();
+  vector<int> srcOf(nSolve, -1);
+  if(warm){
+    REAL d, dmin;
+    for(int q = nLag ; q < nSolve ; ++q){
+      dmin = HUGE_VAL;
+      for(int r = 0 ; r <= q-nLag ; ++r){
+	const parameters& a = calib[order[q]];
+	const parameters& b = calib[order[r]];
+	if(a.zMethod != b.zMethod || a.eta != b.eta ||
+	   (a.gamma > 0) != (b.gamma > 0)) continue;
+	d = paramDist(pv[order[q]], pv[order[r]], range);
+	if(d < dmin){dmin = d; srcOf[q] = order[r];}
+      }
+    }
+  }
+
+  // byte offsets of the solutions in the output file
+  const int nIndex = nParam+6;
+  vector<long long> offV(nSolve), offG(nSolve);
+  long long off = 2*sizeof(int) + (long long)nSolve*nIndex*sizeof(REAL);
+  for(int s = 0 ; s < nSolve ; ++s){
+    offV[s] = off;
+    off += (long long)calib[s].nk*calib[s].nz*sizeof(REAL);
+  }
+  for(int s = 0 ; s < nSolve ; ++s){
+    offG[s] = off;
+    off += (long long)calib[s].nk*calib[s].nz*sizeof(int);
+  }
+  int fd = open(outName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if(fd < 0){
+    cerr << "Could not open " << outName << endl;
+    return 1;
+  }
+
+  // solve calibrations in path order, in parallel, reusing workspaces
+  // within each thread and warm starting from finished neighbours
+  MatrixXR index(nIndex, nSolve);
+  vector<char> done(nSolve, 0);
+  bool ok = true;
+#pragma omp parallel
+  {
+    MatrixXR V0, V, Vsrc, Vcold;
+    MatrixXi G, Gcold;
+#pragma omp for schedule(dynamic,1)
+    for(int q = 0 ; q < nSolve ; ++q){
+      const int s = order[q];
+      const parameters& p = calib[s];
+      const VectorXR& K = Ks[kIx[s]];
+      const VectorXR& Z = Zs[zIx[s]];
+      const MatrixXR& P = Ps[zIx[s]];
+      double t0 = curr_second();
+      V0.resize(p.nk, p.nz);
+      V.resize(p.nk, p.nz);
+      G.resize(p.nk, p.nz);
+
+      // wait for the warm start source to finish
+      int src = srcOf[q];
+      bool ready = src < 0;
+      while(!ready){
+#pragma omp critical(sweepDone)
+	ready = done[src] != 0;
+	if(!ready) usleep(1000);
+      }
+
+      // warm or cold start
+      REAL saved = 0.0;
+      int iter;
+      if(src >= 0){
+	const parameters& ps = calib[src];
+	Vsrc.resize(ps.nk, ps.nz);
+	const size_t nbs = (size_t)ps.nk*ps.nz*sizeof(REAL);
+	if(pread(fd, Vsrc.data(), nbs, offV[src]) != (ssize_t)nbs) src = -1;
+      }
+      if(src >= 0){
+	iter = vfSolveWarm(p, K, Z, P, calib[src].beta, Ks[kIx[src]],
+			   Zs[zIx[src]], Vsrc, V0, V, G);
+      } else {
+	vfInit(p, Z, V0);
+	iter = vfSolve(p, K, Z, P, V0, V, G);
+      }
+      double solTime = curr_second() - t0;
+
+      // iterations saved, against a cold solve
+      if(bench && src >= 0){
+	Vcold.resize(p.nk, p.nz);
+	Gcold.resize(p.nk, p.nz);
+	vfInit(p, Z, V0);
+	saved = vfSolve(p, K, Z, P, V0, Vcold, Gcold) - iter;
+      }
+      const size_t nb = (size_t)p.nk*p.nz;
+      if(pwrite(fd, V.data(), nb*sizeof(REAL), offV[s]) != (ssize_t)(nb*sizeof(REAL)) ||
+	 pwrite(fd, G.data(), nb*sizeof(int), offG[s]) != (ssize_t)(nb*sizeof(int))){
+#pragma omp critical
+	ok = false;
+      }
+#pragma omp critical(sweepDone)
+      done[s] = 1;
+      vector<REAL> pv = paramVec(p);
+      for(int ix = 0 ; ix < nParam ; ++ix) index(ix,s) = pv[ix];
+      index(nParam,s) = iter;
+      index(nParam+1,s) = solTime;
+      index(nParam+2,s) = offV[s];
+      index(nParam+3,s) = offG[s];
+      index(nParam+4,s) = src;
+      index(nParam+5,s) = saved;
+    }
+  }
+
+  // write the header and index
+  int header[2] = {nSolve, nParam};
+  const size_t nIx = sizeof(REAL)*nIndex*nSolve;
+  if(pwrite(fd, header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+     pwrite(fd, index.data(), nIx, sizeof(header)) != (ssize_t)nIx) ok = false;
+  close(fd);
+  if(!ok){
+    cerr << "Could not write " << outName << endl;
+    return 1;
+  }
+
+  // throughput
+  double totalTime = curr_second() - tic;
+  ofstream fileTime;
+  fileTime.open("sweepTimeCPP.dat");
+  fileTime << totalTime << endl;
+  const REAL meanSaved = index.row(nParam+5).mean();
+  fileTime << 3600.0*nSolve/totalTime << endl;
+  fileTime << meanSaved << endl;
+  fileTime.close();
+  cout << nSolve << " solves in " << totalTime << " seconds ("
+       << 3600.0*nSolve/totalTime << " solves per hour, "
+       << meanSaved << " iterations saved per solve)" << endl;
+
+  return 0;
+}
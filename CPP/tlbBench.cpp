@@ -0,0 +1,256 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file tlbBench.cpp
+///
+/// @brief File containing main function for a benchmark of huge page
+/// backing of the solver buffers.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+using namespace std;
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @class benchState
+///
+/// @brief Object to store the state of a benchmark run.
+///
+//////////////////////////////////////////////////////////////////////////////
+class benchState{
+ public:
+  int nIter; ///< Number of iterations to time.
+  long hugeKB; ///< Anonymous memory in huge pages at the last iteration (kB).
+};
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to read the amount of anonymous memory of the process
+/// backed by huge pages.
+///
+/// @returns Size in kB (AnonHugePages in /proc/self/smaps_rollup), or -1
+/// if unavailable.
+///
+//////////////////////////////////////////////////////////////////////////////
+static long anonHugeKB()
+{
+  ifstream fileIn("/proc/self/smaps_rollup");
+  string line;
+  while(getline(fileIn, line)){
+    if(line.compare(0, 14, "AnonHugePages:") == 0) return atol(line.c_str()+14);
+  }
+  return -1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Progress callback which stops the iteration after a fixed number
+/// of iterations and records the huge page backing.
+///
+/// @param [in] iter Number of iterations performed.
+/// @param [in] diff Sup norm of the last update (unused).
+/// @param [in,out] data Pointer to an object of class benchState.
+///
+/// @returns Nonzero to stop the iteration.
+///
+//////////////////////////////////////////////////////////////////////////////
+static int benchProgress(int iter, REAL diff, void* data)
+{
+  (void)diff;
+  benchState* state = (benchState*)data;
+  if(iter < state->nIter) return 0;
+  state->hugeKB = anonHugeKB();
+  return 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to open counters of data TLB load misses of the OpenMP
+/// threads.
+///
+/// @details A counter attached to a thread counts only that thread, and
+/// counters inherited by new threads do not include threads which already
+/// exist, so one counter is opened by each thread of the (already started)
+/// OpenMP pool. Since the pool persists between parallel regions, the
+/// counters cover the threads which run the maximization in @link vfStep
+/// @endlink.
+///
+/// @param [out] fd File descriptor of the counter of each thread, or empty
+/// if hardware counters are unavailable.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+static void tlbCounters(vector<int>& fd)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HW_CACHE;
+  attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  fd.assign(omp_get_max_threads(), -1);
+  bool ok = true;
+#pragma omp parallel
+  {
+    const int t = omp_get_thread_num();
+    fd[t] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if(fd[t] < 0){
+#pragma omp critical(tlbOpen)
+      ok = false;
+    }
+  }
+  if(!ok){
+    for(size_t t = 0 ; t < fd.size() ; ++t) if(fd[t] >= 0) close(fd[t]);
+    fd.clear();
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @fn main()
+///
+/// @brief Main function for a benchmark of huge page backing.
+///
+/// @details This function runs a fixed number of value function iterations
+/// (50 by default, or the first argument) for the calibration in
+/// `../parameters.txt' with the solver buffers backed by base pages
+/// (VFI_HUGEPAGES=off), transparent huge pages and explicit huge pages (see
+/// @link hugeAlloc @endlink). For each mode it writes a line to
+/// `tlbBenchCPP.dat' with the mode (0 off, 1 transparent, 2 explicit), the
+/// backing obtained (see hugeKind), the data TLB load misses per
+/// iteration (-1 where hardware counters are unavailable), the time per
+/// iteration in seconds and the anonymous memory backed by huge pages
+/// during the iteration in kB. Worker threads are started before any
+/// measurement, so that their stacks are not counted, and the misses are
+/// summed over one counter per thread (see @link tlbCounters @endlink),
+/// enabled around the solve only.
+///
+/// @details Usage: `./tlbBench [nIter]'.
+///
+/// @returns 0 upon successful completion, 1 otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+  // Load parameters
+  parameters params;
+  params.load("../parameters.txt");
+  const int nk = params.nk;
+  const int nz = params.nz;
+  benchState state;
+  state.nIter = argc > 1 ? atoi(argv[1]) : 50;
+
+  // grids and initial VF
+  VectorXR K(nk);
+  VectorXR Z(nz);
+  MatrixXR P(nz, nz);
+  MatrixXR Vinit(nk, nz), V0, V(nk, nz);
+  MatrixXi G(nk, nz);
+  const size_t nb = (size_t)nk*nz;
+  ar1(params, Z, P);
+  kGrid(params, Z, K);
+  vfInit(params, Z, Vinit);
+
+  // warm up the thread pool
+  V0 = Vinit;
+  state.nIter = 1;
+  vfSolve(params, K, Z, P, V0, V, G, benchProgress, &state);
+  state.nIter = argc > 1 ? atoi(argv[1]) : 50;
+
+  const char* modes[] = {"off", "transparent", ""};
+  ofstream fileBench;
+  fileBench.open("tlbBenchCPP.dat");
+  for(int m = 0 ; m < 3 ; ++m){
+    setenv("VFI_HUGEPAGES", modes[m], 1);
+    int kind, kind1, kindG;
+    REAL* buf0 = (REAL*)hugeAlloc(nb*sizeof(REAL), kind);
+    REAL* buf1 = (REAL*)hugeAlloc(nb*sizeof(REAL), kind1);
+    int* bufG = (int*)hugeAlloc(nb*sizeof(int), kindG);
+    if(buf0 == NULL || buf1 == NULL || bufG == NULL ||
+       (m == 2 && kind != hugeExplicit)){
+      if(buf0 != NULL) hugeFree(buf0, nb*sizeof(REAL), kind);
+      if(buf1 != NULL) hugeFree(buf1, nb*sizeof(REAL), kind1);
+      if(bufG != NULL) hugeFree(bufG, nb*sizeof(int), kindG);
+      continue;
+    }
+
+    // solver buffers, first touched with the partition of vfStep
+    Map<MatrixXR> W0(buf0, nk, nz), W(buf1, nk, nz);
+    Map<MatrixXi> WG(bufG, nk, nz);
+#pragma omp parallel
+    for(int j = 0 ; j < nz ; ++j){
+#pragma omp for schedule(static) nowait
+      for(int i = 0 ; i < nk ; ++i){
+	W0(i,j) = Vinit(i,j);
+	W(i,j) = 0.0;
+	WG(i,j) = 0;
+      }
+    }
+    long long misses = -1, count;
+    vector<int> fd;
+    tlbCounters(fd);
+    for(size_t t = 0 ; t < fd.size() ; ++t){
+      ioctl(fd[t], PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd[t], PERF_EVENT_IOC_ENABLE, 0);
+    }
+    double tic = curr_second();
+    vfSolve(params, K, Z, P, W0, W, WG, benchProgress, &state);
+    double time = curr_second() - tic;
+    for(size_t t = 0 ; t < fd.size() ; ++t){
+      ioctl(fd[t], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    if(!fd.empty()) misses = 0;
+    for(size_t t = 0 ; t < fd.size() ; ++t){
+      if(misses >= 0 && read(fd[t], &count, sizeof(count)) == sizeof(count)){
+	misses += count;
+      } else {
+	misses = -1;
+      }
+      close(fd[t]);
+    }
+    hugeFree(buf0, nb*sizeof(REAL), kind);
+    hugeFree(buf1, nb*sizeof(REAL), kind1);
+    hugeFree(bufG, nb*sizeof(int), kindG);
+    fileBench << m << " " << kind << " "
+	      << (misses >= 0 ? (double)misses/state.nIter : -1.0) << " "
+	      << time/state.nIter << " " << state.hugeKB << endl;
+    cout << "VFI_HUGEPAGES=" << modes[m] << ": backing " << kind
+	 << ", dTLB load misses/iteration "
+	 << (misses >= 0 ? (double)misses/state.nIter : -1.0)
+	 << ", seconds/iteration " << time/state.nIter
+	 << ", huge page kB " << state.hugeKB << endl;
+  }
+  fileBench.close();
+  unsetenv("VFI_HUGEPAGES");
+  return 0;
+}
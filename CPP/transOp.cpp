@@ -0,0 +1,85 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file transOp.cpp
+///
+/// @brief File containing function to build the state transition operator
+/// implied by the policy function.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <vector>
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to build the sparse transition operator over (k,z).
+///
+/// @details This function builds the nk*nz x nk*nz matrix T such that the
+/// distribution over states evolves as mu' = T*mu, where states are
+/// stored in column major order (index i+j*nk). Future capital Kp(i,j) may
+/// lie anywhere on [K(0), K(nk-1)]: mass is split between the two
+/// bracketing grid points in proportion to distance (a lottery), which
+/// reduces to a single entry when Kp(i,j) lies on the grid, as it does for
+/// the discrete policy K(G). TFP transitions follow P.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] K Grid of capital values.
+/// @param [in] P TFP transition matrix.
+/// @param [in] Kp Matrix storing future capital values of the policy.
+/// @param [out] T Sparse transition operator (row major).
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void transOp(const parameters& param, const VectorXR& K, const MatrixXR& P,
+	     const MatrixXR& Kp, SpMatR& T)
+{
+  const int nk = param.nk;
+  const int nz = param.nz;
+
+  std::vector< Triplet<REAL> > trip;
+  trip.reserve(2*(size_t)nk*nz*nz);
+  int ihi, ilo;
+  REAL w, kp;
+  for(int j = 0 ; j < nz ; ++j){
+    for(int i = 0 ; i < nk ; ++i){
+
+      // lottery weights on the capital grid
+      kp = Kp(i,j);
+      if(kp <= K(0)){
+	ilo = 0; ihi = 0; w = 1.0;
+      } else if(kp >= K(nk-1)){
+	ilo = nk-1; ihi = nk-1; w = 1.0;
+      } else {
+	ihi = binaryVal(kp, K);
+	ilo = ihi-1;
+	w = (kp-K(ilo))/(K(ihi)-K(ilo));
+      }
+
+      // combine with TFP transitions
+      for(int l = 0 ; l < nz ; ++l){
+	if(P(j,l) == 0) continue;
+	if(w > 0) trip.push_back(Triplet<REAL>(ihi+l*nk, i+j*nk, w*P(j,l)));
+	if(w < 1) trip.push_back(Triplet<REAL>(ilo+l*nk, i+j*nk, (1-w)*P(j,l)));
+      }
+    }
+  }
+  T.resize(nk*nz, nk*nz);
+  T.setFromTriplets(trip.begin(), trip.end());
+}
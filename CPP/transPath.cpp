@@ -0,0 +1,159 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file transPath.cpp
+///
+/// @brief File containing function to compute the transition path of the
+/// Aiyagari model after an unexpected TFP change.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <vector>
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute cash on hand at the prices of period t.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] A Grid of asset values.
+/// @param [in] E Grid of labor efficiency values.
+/// @param [in] Z TFP.
+/// @param [in] K Aggregate capital.
+/// @param [out] cash Cash on hand (nk x nz).
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+static void cashAt(const parameters& param, const VectorXR& A,
+		   const VectorXR& E, const REAL& Z, const REAL& K,
+		   MatrixXR& cash)
+{
+  const REAL r = param.alpha*Z*pow(K,param.alpha-1) - param.delta;
+  const REAL w = (1-param.alpha)*Z*pow(K,param.alpha);
+  cash = ((1+r)*A)*RowVectorXR::Ones(E.size()) +
+    VectorXR::Ones(A.size())*(w*E).transpose();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute the transition path of the Aiyagari model
+/// after an unexpected TFP change.
+///
+/// @details This function computes the perfect foresight path of aggregate
+/// capital after TFP unexpectedly follows the path Zt (one thereafter),
+/// starting from the stationary distribution mu0, and returning to the
+/// steady state with value function Vss after nT periods. Prices in each
+/// period are those of the growth model technology at Zt(t) and Kt(t).
+/// Each iteration performs a backward pass of nT steps of @link
+/// vfStepCash @endlink from Vss, followed by a forward pass which pushes
+/// the distribution through the policy of each period (see @link transOp
+/// @endlink) and records aggregate assets, and then moves Kt towards the
+/// implied path with damping 0.5, until the largest difference is below
+/// tol or after maxIter iterations.
+///
+/// @details The forward pass needs the policies in the opposite order to
+/// that in which the backward pass produces them. Rather than storing nT
+/// value functions, the backward pass keeps only the value function at
+/// the end of each segment of s = ceil(sqrt(nT)) periods. The forward pass
+/// recomputes the policies of each segment from its checkpoint, keeping s
+/// of them. The policies of the first segment are those left by the
+/// backward pass. This stores about 2*sqrt(nT) value and policy functions
+/// and costs about two backward steps per period.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] A Grid of asset values.
+/// @param [in] E Grid of labor efficiency values.
+/// @param [in] P Labor efficiency transition matrix.
+/// @param [in] Zt Path of TFP (nT).
+/// @param [in] Vss Value function of the terminal steady state.
+/// @param [in] mu0 Initial distribution over (a,e).
+/// @param [in] tol Tolerance for the path of capital.
+/// @param [in] maxIter Maximum number of iterations.
+/// @param [in,out] Kt Path of aggregate capital (nT), of which Kt(0) is
+/// given.
+/// @param [out] diff Largest difference in the last iteration.
+///
+/// @returns Number of iterations.
+///
+//////////////////////////////////////////////////////////////////////////////
+int transPath(const parameters& param, const VectorXR& A, const VectorXR& E,
+	      const MatrixXR& P, const VectorXR& Zt, const MatrixXR& Vss,
+	      const VectorXR& mu0, const REAL& tol, const int& maxIter,
+	      VectorXR& Kt, REAL& diff)
+{
+  const int nk = param.nk;
+  const int nz = param.nz;
+  const int nT = Zt.size();
+  const int s = (int)ceil(sqrt((double)nT));
+  const int nSeg = (nT + s - 1)/s;
+
+  // checkpoints (value function at the end of each segment) and the
+  // policies of one segment
+  std::vector<MatrixXR> C(nSeg);
+  std::vector<MatrixXi> H(s, MatrixXi(nk, nz));
+  MatrixXR V0(nk, nz), V1(nk, nz), cash, Ap(nk, nz);
+  VectorXR mu, mun(nk*nz), Knew(nT);
+  SpMatR T;
+  int iter = 0, t, t0, t1;
+  diff = 1.0;
+  while(diff > tol && iter < maxIter){
+
+    // backward pass, keeping the checkpoints
+    C[nSeg-1] = Vss;
+    V1 = Vss;
+    for(t = nT-1 ; t >= 0 ; --t){
+      cashAt(param, A, E, Zt(t), Kt(t), cash);
+      vfStepCash(param, A, cash, P, V1, V0, H[t%s]);
+      V1.swap(V0);
+      if(t%s == 0 && t > 0) C[t/s-1] = V1;
+    }
+
+    // forward pass, recomputing the policies of each segment
+    mu = mu0;
+    Knew(0) = Kt(0);
+    for(int m = 0 ; m < nSeg ; ++m){
+      t0 = m*s;
+      t1 = t0+s < nT ? t0+s : nT;
+      if(m > 0){
+	V1 = C[m];
+	for(t = t1-1 ; t >= t0 ; --t){
+	  cashAt(param, A, E, Zt(t), Kt(t), cash);
+	  vfStepCash(param, A, cash, P, V1, V0, H[t-t0]);
+	  V1.swap(V0);
+	}
+      }
+      for(t = t0 ; t < t1 && t+1 < nT ; ++t){
+	for(int j = 0 ; j < nz ; ++j){
+	  for(int i = 0 ; i < nk ; ++i) Ap(i,j) = A(H[t-t0](i,j));
+	}
+	Knew(t+1) = mu.dot(Map<const VectorXR>(Ap.data(), nk*nz));
+	transOp(param, A, P, Ap, T);
+	spMV(T, mu, mun);
+	mu.swap(mun);
+      }
+    }
+
+    // damped update of the path
+    diff = (Knew-Kt).array().abs().maxCoeff();
+    Kt += 0.5*(Knew-Kt);
+    ++iter;
+  }
+  return iter;
+}
@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file vfBackward.cpp
+///
+/// @brief File containing function to solve a finite horizon problem by
+/// backward induction.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to solve a finite horizon problem by backward induction.
+///
+/// @details Starting from the value after the last age, this function
+/// applies @link vfStep @endlink T times, once for each age from T-1 down
+/// to 0, and stores the policy function of each age in H. The value
+/// functions of intermediate ages are not kept.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] K Grid of capital values.
+/// @param [in] Z Grid of TFP values.
+/// @param [in] P TFP transition matrix.
+/// @param [in] T Number of ages.
+/// @param [in,out] V Terminal value function (after age T-1) on input,
+/// value function at age 0 on output.
+/// @param [out] H Policy functions of ages 0,...,T-1.
+///
+/// @returns true upon success, false if a policy function could not be
+/// stored (see @link polHist::store @endlink).
+///
+//////////////////////////////////////////////////////////////////////////////
+bool vfBackward(const parameters& param, const VectorXR& K,
+		const VectorXR& Z, const MatrixXR& P, const int& T, MatrixXR& V,
+		polHist& H)
+{
+  const int nk = param.nk;
+  const int nz = param.nz;
+  H.init(nk, nz, T);
+  MatrixXR V0(nk, nz);
+  MatrixXi G(nk, nz);
+  for(int t = T-1 ; t >= 0 ; --t){
+    V0.swap(V);
+    vfStep(param, K, Z, P, V0, V, G);
+    if(!H.store(t, G)) return false;
+  }
+  return true;
+}
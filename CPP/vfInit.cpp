@@ -33,7 +33,9 @@ using namespace Eigen;
 /// @details This function initializes the value function at the
 /// deterministic steady state values for each level of TFP: conditional on
 /// a TFP level, the deterministic steady-state value of capital is computed,
-/// as well as the associated value function value.
+/// as well as the associated value function value. The rows of V are
+/// written by the OpenMP threads which update them in @link vfStep
+/// @endlink, so that they are placed on those threads' NUMA nodes.
 ///
 /// @param [in] param Object of class parameters.
 /// @param [in] Z Grid of TFP values.
@@ -42,7 +44,7 @@ using namespace Eigen;
 /// @returns Void.
 ///
 //////////////////////////////////////////////////////////////////////////////
-void vfInit(const parameters& param, const VectorXR& Z, MatrixXR& V)
+void vfInit(const parameters& param, const VectorXR& Z, Ref<MatrixXR> V)
 { 
 
   // basic parameters
@@ -54,7 +56,14 @@ void vfInit(const parameters& param, const VectorXR& Z, MatrixXR& V)
 
   // initialize
   ArrayXR Kj = (((alpha*Z).array().pow(-1))*((1/beta)-1+delta)).pow(1/(alpha-1));
-  V.row(0) = (((Z.array()*Kj.pow(alpha) - delta*Kj).pow(1-eta))/(1-eta)).matrix();
-  for(int ix = 1 ; ix < nk ; ++ix) V.row(ix) = V.row(0);
+  const RowVectorXR V1 = (((Z.array()*Kj.pow(alpha) - delta*Kj).pow(1-eta))/(1-eta)).matrix().transpose();
+
+  // first touch by the threads (and static partition) of vfStep
+  const int nz = V1.size();
+#pragma omp parallel
+  for(int j = 0 ; j < nz ; ++j){
+#pragma omp for schedule(static) nowait
+    for(int ix = 0 ; ix < nk ; ++ix) V(ix,j) = V1(j);
+  }
 
 }
@@ -0,0 +1,82 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file vfSolve.cpp
+///
+/// @brief File containing function to iterate the value function to
+/// convergence.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to iterate the value function to convergence.
+///
+/// @details This function repeatedly applies @link vfStep @endlink,
+/// starting from V0, until the maximum absolute difference between
+/// successive value functions is below the tolerance. If a progress
+/// callback is supplied, it is called after every iteration and may stop
+/// the iteration early by returning nonzero. The iteration works in place
+/// on the caller's matrices, which may be maps of buffers allocated by
+/// @link hugeAlloc @endlink (backed by huge pages where available, to
+/// reduce TLB misses in the maximization) and first touched by @link
+/// vfInit @endlink; V0 is updated with the partition of @link vfStep
+/// @endlink, so that each thread keeps to its own rows.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] K Grid of capital values.
+/// @param [in] Z Grid of TFP values.
+/// @param [in] P TFP transition matrix.
+/// @param [in,out] V0 Initial value function; on exit equal to V.
+/// @param [out] V Converged value function.
+/// @param [out] G Converged policy function.
+/// @param [in] progress Progress callback (may be NULL).
+/// @param [in] data User data passed to the progress callback.
+///
+/// @returns Number of iterations performed.
+///
+//////////////////////////////////////////////////////////////////////////////
+int vfSolve(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	    const MatrixXR& P, Ref<MatrixXR> V0, Ref<MatrixXR> V,
+	    Ref<MatrixXi> G, vfProgress progress, void* data)
+{
+  const int nk = param.nk;
+  const int nz = param.nz;
+
+  REAL diff = 1.0;
+  int count = 0;
+  while(fabs(diff) > param.tol){
+    vfStep(param, K, Z, P, V0, V, G);
+
+    // sup norm of the update and copy, with the partition of vfStep
+    diff = 0.0;
+#pragma omp parallel reduction(max:diff)
+    for(int j = 0 ; j < nz ; ++j){
+#pragma omp for schedule(static) nowait
+      for(int i = 0 ; i < nk ; ++i){
+	diff = fmax(diff, fabs(V(i,j)-V0(i,j)));
+	V0(i,j) = V(i,j);
+      }
+    }
+    ++count;
+    if(progress != NULL && progress(count, diff, data) != 0) break;
+  }
+  return count;
+}
@@ -0,0 +1,66 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file vfSolveWarm.cpp
+///
+/// @brief File containing function to iterate the value function to
+/// convergence from a previous solution.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to iterate the value function to convergence from a
+/// previous solution.
+///
+/// @details This function interpolates the previous solution Vsrc onto
+/// the current grids and rescales it by (1-betaSrc)/(1-beta) with @link
+/// vfWarm @endlink, and iterates from it to convergence with @link vfSolve
+/// @endlink.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] K Grid of capital values.
+/// @param [in] Z Grid of TFP values.
+/// @param [in] P TFP transition matrix.
+/// @param [in] betaSrc Time discount factor of the previous solution.
+/// @param [in] Ksrc Capital grid of the previous solution.
+/// @param [in] Zsrc TFP grid of the previous solution.
+/// @param [in] Vsrc Previous value function.
+/// @param [out] V0 Workspace for the initial value function.
+/// @param [out] V Converged value function (nk x nz, sized by the
+/// caller).
+/// @param [out] G Converged policy function (nk x nz, sized by the
+/// caller).
+/// @param [in] progress Progress callback (may be NULL), see @link vfSolve
+/// @endlink.
+/// @param [in] data User data passed to the progress callback.
+///
+/// @returns Number of iterations performed.
+///
+//////////////////////////////////////////////////////////////////////////////
+int vfSolveWarm(const parameters& param, const VectorXR& K, const VectorXR& Z,
+		const MatrixXR& P, const REAL& betaSrc, const VectorXR& Ksrc,
+		const VectorXR& Zsrc, const Ref<const MatrixXR>& Vsrc,
+		MatrixXR& V0, Ref<MatrixXR> V, Ref<MatrixXi> G,
+		vfProgress progress, void* data)
+{
+  V0.resize(param.nk, param.nz);
+  vfWarm(Ksrc, Zsrc, Vsrc, (1-betaSrc)/(1-param.beta), K, Z, V0);
+  return vfSolve(param, K, Z, P, V0, V, G, progress, data);
+}
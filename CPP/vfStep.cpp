@@ -35,7 +35,15 @@ using namespace Eigen;
 /// @details This function performs one iteration of the value function
 /// iteration algorithm, using V0 as the current value function, maximizing
 /// the LHS of the Bellman. Maximization is performed by @link binaryMax
-/// @endlink.
+/// @endlink. The capital indices are divided among OpenMP threads with a
+/// static schedule. Expectations are taken over the band of each row of
+/// the transition matrix given by @link pBand @endlink with tolerance
+/// param.pTol. Under Epstein-Zin preferences (param.gamma > 0), the
+/// certainty equivalents of all future capital values are instead computed
+/// once, before the maximization, by @link ezExp @endlink. If param.guard
+/// is set, the maximization is performed by @link binaryMaxGuard @endlink,
+/// which falls back to a grid search in the states where the objective is
+/// not concave.
 ///
 /// @param [in] param Object of class parameters.
 /// @param [in] K Grid of capital values.
@@ -45,11 +53,13 @@ using namespace Eigen;
 /// @param [out] V Matrix storing updated value function.
 /// @param [in,out] G Matrix storing policy function.
 ///
-/// @returns Void.
+/// @returns Number of states in which concavity was violated (0 unless
+/// param.guard is set).
 ///
 //////////////////////////////////////////////////////////////////////////////
-void vfStep(const parameters& param, const VectorXR& K, const VectorXR& Z,
-	    const MatrixXR& P, const MatrixXR& V0, MatrixXR& V, MatrixXi& G)
+int vfStep(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	   const MatrixXR& P, const Ref<const MatrixXR>& V0, Ref<MatrixXR> V,
+	   Ref<MatrixXi> G)
 {
 
   // Basic parameters
@@ -60,33 +70,71 @@ void vfStep(const parameters& param, const VectorXR& K, const VectorXR& Z,
   const REAL alpha = param.alpha;
   const REAL delta = param.delta;
 
-  // output and depreciated capital
-  MatrixXR ydepK = (K.array().pow(alpha)).matrix()*Z.transpose();
-  ydepK.colwise() += (1-delta)*K;
+  // banded approximation of the transition matrix
+  MatrixXR Pt;
+  VectorXi plo, plen;
+  pBand(P, param.pTol, Pt, plo, plen);
 
+  // Epstein-Zin certainty equivalents (transcendentals once per state
+  // rather than once per evaluation of the maximand)
+  const bool ez = param.gamma > 0;
+  MatrixXR X;
+  if(ez) ezExp(param, Pt, V0, X);
+  const bool guard = param.guard != 0;
+
+  // the capital indices are divided among threads with the same static
+  // schedule as in vfInit and vfSolve, so that each thread writes the rows
+  // of V and G which it touched first (and which therefore reside on its
+  // own NUMA node); the continuation values of each state are read from
+  // rows 0,...,khi of V0, nearly the whole matrix, and so from all nodes
   int klo, khi, nksub;
-  VectorXR Exp, w;
-  VectorXR::Index indMax;
+  int nBad = 0;
+  REAL ydepK, yK;
+  VectorXR Exp;
+#pragma omp parallel for schedule(static) private(klo,khi,nksub,ydepK,yK,Exp) reduction(+:nBad)
   for(int i = 0 ; i < nk ; ++i){
+    yK = pow(K(i),alpha);
     for(int j = 0 ; j < nz ; ++j){
 
+      // output and depreciated capital
+      ydepK = yK*Z(j) + (1-delta)*K(i);
+
       // impose constraints on grid for future capital
       klo = 0;
-      khi = binaryVal(ydepK(i,j), K); // consumption nonnegativity
-      if(K[khi] > ydepK(i,j)) khi -= 1;
+      khi = binaryVal(ydepK, K); // consumption nonnegativity
+      if(K[khi] > ydepK) khi -= 1;
       nksub = khi-klo+1;
 
+      // maximization with Epstein-Zin certainty equivalents
+      if(ez && guard){
+	nBad += binaryMaxGuard(klo, nksub, ydepK, eta, beta, K,
+			       X.col(j).segment(klo, nksub), V(i,j), G(i,j));
+	continue;
+      } else if(ez){
+	binaryMax(klo, nksub, ydepK, eta, beta, K, X.col(j).segment(klo, nksub),
+		  V(i,j), G(i,j));
+	continue;
+      }
+
       // continuation value for subgrid
       // note that this computes more values than necessary for
       // the maximization methods, but the Eigen matrix multiply
       // is so efficient that it is faster to compute all possible
       // continuation values outside of the max routine rather than
-      // only the necessary values inside the routine.
-      Exp = V0.block(klo, 0, nksub, nz)*P.row(j).transpose();
+      // only the necessary values inside the routine. The product is
+      // taken only over the band of P.row(j).
+      Exp = V0.block(klo, plo(j), nksub, plen(j))*
+	Pt.row(j).segment(plo(j), plen(j)).transpose();
 
       // maximization
-      binaryMax(klo, nksub, ydepK(i,j), eta, beta, K, Exp, V(i,j), G(i,j));
+      if(guard){
+	nBad += binaryMaxGuard(klo, nksub, ydepK, eta, beta, K, Exp, V(i,j),
+			       G(i,j));
+      } else {
+	binaryMax(klo, nksub, ydepK, eta, beta, K, Exp, V(i,j), G(i,j));
+      }
 
     }
   }
+  return nBad;
 }
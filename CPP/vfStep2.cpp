@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file vfStep2.cpp
+///
+/// @brief File containing function to update the value function with TFP
+/// and investment-specific shocks.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to update the value function with TFP and
+/// investment-specific shocks.
+///
+/// @details This function performs one iteration of value function
+/// iteration for the growth model with an investment-specific shock q,
+/// independent of TFP, in the law of motion k' = (1-delta)k + q*i. The
+/// shock state j = j1 + n1*j2 combines TFP Z(j1) and q = Q(j2), and the
+/// expected continuation values are computed once per iteration by @link
+/// kronExp @endlink. Consumption is c = (q*z*k^alpha + (1-delta)k - k')/q,
+/// so that the Bellman objective is q^(eta-1) times the standard objective
+/// with resources q*z*k^alpha + (1-delta)k and discount factor
+/// beta*q^(1-eta), which is maximized by @link binaryMax @endlink. The
+/// capital indices are divided among OpenMP threads with a static
+/// schedule.
+///
+/// @param [in] param Object of class parameters (nz = n1*n2).
+/// @param [in] K Grid of capital values.
+/// @param [in] Z Grid of TFP values (n1).
+/// @param [in] Q Grid of investment-specific shock values (n2).
+/// @param [in] P1 TFP transition matrix.
+/// @param [in] P2 Investment-specific shock transition matrix.
+/// @param [in] V0 Matrix storing current value function.
+/// @param [out] V Matrix storing updated value function.
+/// @param [out] G Matrix storing policy function.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void vfStep2(const parameters& param, const VectorXR& K, const VectorXR& Z,
+	     const VectorXR& Q, const MatrixXR& P1, const MatrixXR& P2,
+	     const MatrixXR& V0, MatrixXR& V, MatrixXi& G)
+{
+
+  // Basic parameters
+  const int nk = param.nk;
+  const int n1 = Z.size();
+  const int n2 = Q.size();
+  const REAL eta = param.eta;
+  const REAL beta = param.beta;
+  const REAL alpha = param.alpha;
+  const REAL delta = param.delta;
+
+  // expected continuation values
+  MatrixXR EV;
+  kronExp(V0, P1, P2, EV);
+
+  int j, khi;
+  REAL ydepK, yK, w;
+#pragma omp parallel for schedule(static) private(j,khi,ydepK,yK,w)
+  for(int i = 0 ; i < nk ; ++i){
+    yK = pow(K(i),alpha);
+    for(int j2 = 0 ; j2 < n2 ; ++j2){
+      for(int j1 = 0 ; j1 < n1 ; ++j1){
+	j = j1 + n1*j2;
+
+	// resources in units of capital
+	ydepK = Q(j2)*Z(j1)*yK + (1-delta)*K(i);
+	khi = binaryVal(ydepK, K); // consumption nonnegativity
+	if(K[khi] > ydepK) khi -= 1;
+
+	// maximization of the rescaled objective
+	binaryMax(0, khi+1, ydepK, eta, beta*pow(Q(j2),1-eta), K, EV.col(j),
+		  w, G(i,j));
+	V(i,j) = pow(Q(j2),eta-1)*w;
+      }
+    }
+  }
+}
@@ -0,0 +1,77 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file vfStepCash.cpp
+///
+/// @brief File containing function to update the value function of a
+/// household with given cash on hand.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to update the value function of a household with given
+/// cash on hand.
+///
+/// @details This function performs one iteration of value function
+/// iteration for the problem max u(x - a') + beta*E[V(a',e')] over a' on
+/// the grid A, where cash on hand x = cash(i,j) is given for each asset
+/// index i and shock index j (e.g. (1+r)*A(i) + w*E(j) in an income
+/// fluctuation problem). The expected continuation values are computed
+/// once per iteration and the maximization is performed by @link binaryMax
+/// @endlink, with cash on hand in the place of output and depreciated
+/// capital. The asset indices are divided among OpenMP threads with a
+/// static schedule.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] A Grid of asset values.
+/// @param [in] cash Cash on hand (nk x nz).
+/// @param [in] P Shock transition matrix.
+/// @param [in] V0 Matrix storing current value function.
+/// @param [out] V Matrix storing updated value function.
+/// @param [out] G Matrix storing policy function.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void vfStepCash(const parameters& param, const VectorXR& A,
+		const MatrixXR& cash, const MatrixXR& P, const MatrixXR& V0,
+		MatrixXR& V, MatrixXi& G)
+{
+
+  // Basic parameters
+  const int nk = param.nk;
+  const int nz = param.nz;
+  const REAL eta = param.eta;
+  const REAL beta = param.beta;
+
+  // expected continuation values
+  MatrixXR EV;
+  EV.noalias() = V0*P.transpose();
+
+  int khi;
+#pragma omp parallel for schedule(static) private(khi)
+  for(int i = 0 ; i < nk ; ++i){
+    for(int j = 0 ; j < nz ; ++j){
+      khi = binaryVal(cash(i,j), A); // consumption nonnegativity
+      if(A[khi] > cash(i,j)) khi -= 1;
+      binaryMax(0, khi+1, cash(i,j), eta, beta, A, EV.col(j), V(i,j), G(i,j));
+    }
+  }
+}
@@ -0,0 +1,157 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file vfStepDef.cpp
+///
+/// @brief File containing function to update the value function and bond
+/// prices of the sovereign default model.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to maximize the repayment objective over a range of
+/// bond holdings using the monotonicity of the policy.
+///
+/// @details The repayment policy is nondecreasing in current bond holdings
+/// (the objective has increasing differences in B(i) and the cost
+/// q(l,j)*B(l), and the value is increasing in B(l), so that optimal
+/// choices with more debt cost less), so that the policy for states
+/// ilo,...,ihi lies between the policies lo and hi of the neighbouring
+/// states. The middle state is solved by @link gridMax @endlink over
+/// lo,...,hi, and its policy bounds the searches of the two halves, which
+/// are solved in the same way. Each level of the recursion costs at most
+/// nb+ihi-ilo evaluations, so that a column costs O(nb*log(nb)) rather than
+/// nb^2.
+///
+/// @param [in] ilo First state of the range.
+/// @param [in] ihi Last state of the range.
+/// @param [in] lo Smallest admissible policy.
+/// @param [in] hi Largest admissible policy.
+/// @param [in] y Endowment.
+/// @param [in] eta Coefficient of relative risk aversion.
+/// @param [in] beta Time discount factor.
+/// @param [in] B Grid of bond holdings.
+/// @param [in] QB Cost of each choice, q(l,j)*B(l).
+/// @param [in] E Expected continuation values.
+/// @param [out] W Repayment values.
+/// @param [out] G Policies under repayment.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+static void monoMax(const int& ilo, const int& ihi, const int& lo,
+		    const int& hi, const REAL& y, const REAL& eta,
+		    const REAL& beta, const VectorXR& B,
+		    const Ref<const VectorXR>& QB,
+		    const Ref<const VectorXR>& E, Ref<VectorXR> W,
+		    Ref<VectorXi> G)
+{
+  if(ilo > ihi) return;
+  const int i = (ilo + ihi)/2;
+  gridMax(lo, hi-lo+1, y+B(i), eta, beta, QB, E.segment(lo, hi-lo+1),
+	  W(i), G(i));
+  monoMax(ilo, i-1, lo, G(i), y, eta, beta, B, QB, E, W, G);
+  monoMax(i+1, ihi, G(i), hi, y, eta, beta, B, QB, E, W, G);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to update the value function and bond prices of the
+/// sovereign default model.
+///
+/// @details This function performs one iteration of value function
+/// iteration for a sovereign with endowment Y(j) and bond holdings B(i)
+/// (negative for debt), as in Arellano (2008). Under repayment the
+/// sovereign chooses B(l) at the price q(l,j) and consumes
+/// Y(j) + B(i) - q(l,j)*B(l); under default it consumes Yd(j), is excluded
+/// from markets and regains access with zero debt with probability theta.
+/// The expectation stage is fused with the price update: the current
+/// values V0, default indicators D0 and exclusion continuation values are
+/// stacked and multiplied by P' once, giving the expected continuation
+/// values and the default probabilities that set the prices
+/// q = (1-E[D0])/(1+r) used in this iteration. Since the price schedule
+/// makes the repayment objective nonconcave in B(l), it is maximized by
+/// grid search, restricted by the monotonicity of the policy in B(i) (see
+/// @link monoMax @endlink). The endowment states are divided among OpenMP
+/// threads with a static schedule.
+///
+/// @param [in] param Object of class parameters (eta and beta).
+/// @param [in] r Risk-free interest rate.
+/// @param [in] theta Probability of regaining market access.
+/// @param [in] B Grid of bond holdings (nb).
+/// @param [in] Y Grid of endowments (ny).
+/// @param [in] Yd Endowments under default (ny).
+/// @param [in] P Endowment transition matrix.
+/// @param [in] i0 Index of zero bond holdings in B.
+/// @param [in] V0 Matrix storing current value function (nb x ny).
+/// @param [in] Vd0 Vector storing current value of default (ny).
+/// @param [in] D0 Matrix storing current default indicators (nb x ny).
+/// @param [out] V Matrix storing updated value function.
+/// @param [out] Vd Vector storing updated value of default.
+/// @param [out] D Matrix storing updated default indicators.
+/// @param [out] q Matrix storing bond prices q(l,j) implied by D0.
+/// @param [out] G Matrix storing policy function under repayment.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void vfStepDef(const parameters& param, const REAL& r, const REAL& theta,
+	       const VectorXR& B, const VectorXR& Y, const VectorXR& Yd,
+	       const MatrixXR& P, const int& i0, const MatrixXR& V0,
+	       const VectorXR& Vd0, const MatrixXR& D0, MatrixXR& V,
+	       VectorXR& Vd, MatrixXR& D, MatrixXR& q, MatrixXi& G)
+{
+
+  // Basic parameters
+  const int nb = B.size();
+  const int ny = Y.size();
+  const REAL eta = param.eta;
+  const REAL beta = param.beta;
+
+  // fused expectation and price stage
+  MatrixXR X(2*nb+1, ny), E;
+  X.topRows(nb) = V0;
+  X.middleRows(nb, nb) = D0;
+  X.row(2*nb) = theta*V0.row(i0) + (1-theta)*Vd0.transpose();
+  E.noalias() = X*P.transpose();
+  q = (1-E.middleRows(nb, nb).array())/(1+r);
+  MatrixXR QB = q.array().colwise()*B.array();
+
+  // value of default
+  for(int j = 0 ; j < ny ; ++j){
+    Vd(j) = pow(Yd(j),1-eta)/(1-eta) + beta*E(2*nb,j);
+  }
+
+  // repayment and default decision
+#pragma omp parallel for schedule(static)
+  for(int j = 0 ; j < ny ; ++j){
+    monoMax(0, nb-1, 0, nb-1, Y(j), eta, beta, B, QB.col(j),
+	    E.col(j).head(nb), V.col(j), G.col(j));
+    for(int i = 0 ; i < nb ; ++i){
+      if(Vd(j) > V(i,j)){
+	V(i,j) = Vd(j);
+	D(i,j) = 1;
+      } else {
+	D(i,j) = 0;
+      }
+    }
+  }
+}
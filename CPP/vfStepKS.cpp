@@ -0,0 +1,156 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file vfStepKS.cpp
+///
+/// @brief File containing function to update the household value function
+/// in the Krusell-Smith model.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute expected continuation values in the
+/// Krusell-Smith model.
+///
+/// @details For each aggregate capital Kb(m) and TFP state jz, V0 is
+/// interpolated linearly in aggregate capital at the forecast Kb'
+/// (extrapolated outside the grid), and the expectation over the
+/// independent shocks is taken in two stages, as in @link kronExp
+/// @endlink: first over z' for each e', then over e'.
+///
+/// @param [in] Kb Grid of aggregate capital values.
+/// @param [in] Pz TFP transition matrix.
+/// @param [in] Pe Labor efficiency transition matrix.
+/// @param [in] B Forecast rule coefficients (nz x 2).
+/// @param [in] V0 Value function.
+/// @param [out] EV Expected continuation values (column j + nJ*m holds
+/// the values for current state (m,j) over future household capital).
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+static void ksExp(const VectorXR& Kb, const MatrixXR& Pz, const MatrixXR& Pe,
+		  const MatrixXR& B, const MatrixXR& V0, MatrixXR& EV)
+{
+  const int nk = V0.rows();
+  const int nKb = Kb.size();
+  const int nz = Pz.rows();
+  const int nE = Pe.rows();
+  const int nJ = nz*nE;
+  EV.resize(nk, nKb*nJ);
+#pragma omp parallel for schedule(static)
+  for(int c = 0 ; c < nKb*nz ; ++c){
+    const int m = c%nKb, jz = c/nKb;
+    const REAL Kf = exp(B(jz,0) + B(jz,1)*log(Kb(m)));
+    int mhi = binaryVal(Kf, Kb);
+    if(mhi == 0) mhi = 1;
+    const int mlo = mhi-1;
+    const REAL w = (Kf-Kb(mlo))/(Kb(mhi)-Kb(mlo));
+    const MatrixXR Vi = (1-w)*V0.middleCols(nJ*mlo, nJ) +
+      w*V0.middleCols(nJ*mhi, nJ);
+    MatrixXR W(nk, nE);
+    for(int le = 0 ; le < nE ; ++le){
+      W.col(le).noalias() = Vi.middleCols(nz*le, nz)*Pz.row(jz).transpose();
+    }
+    const MatrixXR Eb = W*Pe.transpose();
+    for(int je = 0 ; je < nE ; ++je) EV.col(jz + nz*je + nJ*m) = Eb.col(je);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to update the household value function in the
+/// Krusell-Smith model.
+///
+/// @details The household state is its capital k = A(i), aggregate capital
+/// Kb(m), aggregate TFP Z(jz) and labor efficiency E(je), with the
+/// exogenous states combined as j = jz + nz*je, and value and policy
+/// functions stored in column j + nJ*m (nJ = nz*nE). Aggregate labor is
+/// one, so that prices are r = alpha*z*Kb^(alpha-1) - delta and
+/// w = (1-alpha)*z*Kb^alpha, and households forecast aggregate capital
+/// with the log-linear rule log(Kb') = B(jz,0) + B(jz,1)*log(Kb).
+///
+/// @details Expected continuation values are computed once per step (see
+/// @link ksExp @endlink) and the maximization over future capital is
+/// performed by @link binaryMax @endlink with cash on hand (1+r)*k + w*e.
+/// The capital indices are divided among OpenMP threads with a static
+/// schedule.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] A Grid of household capital values.
+/// @param [in] Kb Grid of aggregate capital values.
+/// @param [in] Z Grid of TFP values.
+/// @param [in] E Grid of labor efficiency values.
+/// @param [in] Pz TFP transition matrix.
+/// @param [in] Pe Labor efficiency transition matrix.
+/// @param [in] B Forecast rule coefficients (nz x 2).
+/// @param [in] V0 Matrix storing current value function.
+/// @param [out] V Matrix storing updated value function.
+/// @param [out] G Matrix storing policy function.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void vfStepKS(const parameters& param, const VectorXR& A, const VectorXR& Kb,
+	      const VectorXR& Z, const VectorXR& E, const MatrixXR& Pz,
+	      const MatrixXR& Pe, const MatrixXR& B, const MatrixXR& V0,
+	      MatrixXR& V, MatrixXi& G)
+{
+
+  // Basic parameters
+  const int nk = A.size();
+  const int nKb = Kb.size();
+  const int nz = Z.size();
+  const int nE = E.size();
+  const int nJ = nz*nE;
+  const REAL eta = param.eta;
+  const REAL beta = param.beta;
+  const REAL alpha = param.alpha;
+  const REAL delta = param.delta;
+
+  // prices
+  MatrixXR R(nKb, nz), Wage(nKb, nz);
+  for(int jz = 0 ; jz < nz ; ++jz){
+    for(int m = 0 ; m < nKb ; ++m){
+      R(m,jz) = alpha*Z(jz)*pow(Kb(m),alpha-1) - delta;
+      Wage(m,jz) = (1-alpha)*Z(jz)*pow(Kb(m),alpha);
+    }
+  }
+
+  // maximization
+  MatrixXR EV;
+  ksExp(Kb, Pz, Pe, B, V0, EV);
+  int jz, c, khi;
+  REAL cash;
+#pragma omp parallel for schedule(static) private(jz,c,khi,cash)
+  for(int i = 0 ; i < nk ; ++i){
+    for(int m = 0 ; m < nKb ; ++m){
+      for(int j = 0 ; j < nJ ; ++j){
+	jz = j%nz;
+	c = j + nJ*m;
+	cash = (1+R(m,jz))*A(i) + Wage(m,jz)*E(j/nz);
+	khi = binaryVal(cash, A); // consumption nonnegativity
+	if(A[khi] > cash) khi -= 1;
+	binaryMax(0, khi+1, cash, eta, beta, A, EV.col(c), V(i,c), G(i,c));
+      }
+    }
+  }
+}
@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file vfStepTab.cpp
+///
+/// @brief File containing function to update the value function with
+/// tabulated static utility.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to maximize tabulated utility plus continuation value.
+///
+/// @details A binary search over future capital for the maximum of
+/// U(kp) + beta*Exp(kp), kp = 0,...,nksub-1, which is assumed to be concave,
+/// as in @link binaryMax @endlink. U and Exp point to the first future
+/// capital value of the band.
+///
+/// @param [in] nksub Number of feasible future capital values.
+/// @param [in] U Static utility over future capital.
+/// @param [in] beta Time discount factor.
+/// @param [in] Exp Expected continuation values over future capital.
+/// @param [out] V Maximum.
+/// @param [out] G Index of the maximizing future capital.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+static void tabMax(const int& nksub, const REAL* U, const REAL& beta,
+		   const REAL* Exp, REAL& V, int& G)
+{
+  // reduce the bracket to three values or fewer
+  int kslo = 0;
+  int kshi = nksub-1;
+  int ksmid;
+  while(kshi-kslo > 2){
+    ksmid = (kslo + kshi)/2;
+    if(U[ksmid+1] + beta*Exp[ksmid+1] > U[ksmid] + beta*Exp[ksmid]){
+      kslo = ksmid;
+    } else {
+      kshi = ksmid+1;
+    }
+  }
+
+  // find the max among the remaining values
+  REAL w;
+  V = U[kslo] + beta*Exp[kslo];
+  G = kslo;
+  for(int ks = kslo+1 ; ks <= kshi ; ++ks){
+    w = U[ks] + beta*Exp[ks];
+    if(w > V){V = w; G = ks;}
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to update the value function with tabulated static
+/// utility.
+///
+/// @details This function performs one iteration of value function
+/// iteration when the period utility for each state and future capital has
+/// been computed in advance, as in the model with elastic labor (see @link
+/// laborTab @endlink). The maximization for each state is restricted to the
+/// tabulated band of future capital, so that a policy on an interior edge
+/// of the band means that the band must be moved and the step repeated.
+/// The expected continuation values are computed once per iteration and
+/// the maximization involves no transcendental functions. The capital
+/// indices are divided among OpenMP threads with a static schedule.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] P TFP transition matrix.
+/// @param [in] U Static utility (column i + nk*j for state (i,j), row b
+/// for future capital index klo(i,j)+b).
+/// @param [in] klo Smallest future capital index of each band.
+/// @param [in] khi Largest feasible future capital index.
+/// @param [in] V0 Matrix storing current value function.
+/// @param [out] V Matrix storing updated value function.
+/// @param [out] G Matrix storing policy function.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void vfStepTab(const parameters& param, const MatrixXR& P, const MatrixXR& U,
+	       const MatrixXi& klo, const MatrixXi& khi, const MatrixXR& V0,
+	       MatrixXR& V, MatrixXi& G)
+{
+
+  // Basic parameters
+  const int nk = param.nk;
+  const int nz = param.nz;
+  const int nb = U.rows();
+  const REAL beta = param.beta;
+
+  // expected continuation values
+  MatrixXR EV;
+  EV.noalias() = V0*P.transpose();
+
+  int kb, nksub;
+#pragma omp parallel for schedule(static) private(kb,nksub)
+  for(int i = 0 ; i < nk ; ++i){
+    for(int j = 0 ; j < nz ; ++j){
+      kb = klo(i,j);
+      nksub = khi(i,j)-kb+1 < nb ? khi(i,j)-kb+1 : nb;
+      tabMax(nksub, &U(0,i+nk*j), beta, &EV(kb,j), V(i,j), G(i,j));
+      G(i,j) += kb;
+    }
+  }
+}
@@ -0,0 +1,119 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file vfWarm.cpp
+///
+/// @brief File containing function to initialize the value function from
+/// a previous solution.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <math.h>
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to compute interpolation weights on a monotone grid.
+///
+/// @param [in] x Value to locate.
+/// @param [in] X Monotone grid.
+/// @param [in] extrap Whether to extrapolate linearly beyond the grid
+/// (otherwise the endpoint value is used).
+/// @param [out] ilo Index of lower bracketing grid point.
+/// @param [out] w Weight on the upper grid point (ilo+1).
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+static void bracket(const REAL& x, const VectorXR& X, const bool extrap,
+		    int& ilo, REAL& w)
+{
+  const int nx = X.size();
+  if(nx == 1){ilo = 0; w = 0.0; return;}
+  if(x <= X(0)){
+    ilo = 0;
+    w = extrap ? (x-X(0))/(X(1)-X(0)) : 0.0;
+  } else if(x >= X(nx-1)){
+    ilo = nx-2;
+    w = extrap ? (x-X(nx-2))/(X(nx-1)-X(nx-2)) : 1.0;
+  } else {
+    ilo = binaryVal(x, X)-1;
+    w = (x-X(ilo))/(X(ilo+1)-X(ilo));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to initialize the value function from a previous
+/// solution.
+///
+/// @details This function warm starts value function iteration from the
+/// solution Vsrc of a nearby problem. If the grids of the two problems
+/// are identical, Vsrc is copied; otherwise it is interpolated bilinearly
+/// in capital and log TFP. Beyond the source capital grid Vsrc is
+/// extrapolated linearly, which preserves the concavity in capital that
+/// @link binaryMax @endlink relies on; beyond the source TFP grid it is
+/// held constant. The result is multiplied by scale, which can be used to
+/// account for the change in the level of the value function across
+/// calibrations (e.g. (1-beta_src)/(1-beta)).
+///
+/// @param [in] Ksrc Capital grid of the previous solution.
+/// @param [in] Zsrc TFP grid of the previous solution.
+/// @param [in] Vsrc Previous value function.
+/// @param [in] scale Factor multiplying the interpolated values.
+/// @param [in] K Grid of capital values.
+/// @param [in] Z Grid of TFP values.
+/// @param [out] V0 Initial value function.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void vfWarm(const VectorXR& Ksrc, const VectorXR& Zsrc,
+	    const Ref<const MatrixXR>& Vsrc,
+	    const REAL& scale, const VectorXR& K, const VectorXR& Z,
+	    MatrixXR& V0)
+{
+  const int nk = K.size();
+  const int nz = Z.size();
+  V0.resize(nk, nz);
+  if(Ksrc.size() == nk && Zsrc.size() == nz && Ksrc == K && Zsrc == Z){
+    V0 = scale*Vsrc;
+    return;
+  }
+
+  // interpolation weights in each dimension
+  const VectorXR logZsrc = Zsrc.array().log().matrix();
+  VectorXi ik(nk), jz(nz);
+  VectorXR wk(nk), wz(nz);
+  for(int i = 0 ; i < nk ; ++i) bracket(K(i), Ksrc, true, ik(i), wk(i));
+  for(int j = 0 ; j < nz ; ++j) bracket(log(Z(j)), logZsrc, false, jz(j), wz(j));
+  const int nks = Ksrc.size();
+  const int nzs = Zsrc.size();
+
+  // bilinear interpolation
+#pragma omp parallel for
+  for(int j = 0 ; j < nz ; ++j){
+    const int jlo = jz(j);
+    const int jhi = nzs > 1 ? jlo+1 : jlo;
+    for(int i = 0 ; i < nk ; ++i){
+      const int ilo = ik(i);
+      const int ihi = nks > 1 ? ilo+1 : ilo;
+      V0(i,j) = scale*((1-wz(j))*((1-wk(i))*Vsrc(ilo,jlo) + wk(i)*Vsrc(ihi,jlo))
+		       + wz(j)*((1-wk(i))*Vsrc(ilo,jhi) + wk(i)*Vsrc(ihi,jhi)));
+    }
+  }
+}
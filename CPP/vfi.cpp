@@ -0,0 +1,132 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file vfi.cpp
+///
+/// @brief File containing the C interface to the embeddable solver.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "vfi.h"
+#include "solver.h"
+#include <new>
+#include <fstream>
+
+static_assert(sizeof(REAL) == sizeof(double),
+	      "The C interface requires REAL to be double");
+
+/// Handle wrapping a Solver for the C interface.
+struct vfiSolver{
+  Solver solver; ///< Solver object.
+  vfiSolver(const parameters& param) : solver(param) {}
+};
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to convert C parameter values to a parameters object.
+///
+/// @param [in] in C parameter values.
+///
+/// @returns Object of class parameters.
+///
+//////////////////////////////////////////////////////////////////////////////
+static parameters toParameters(const vfiParams* in)
+{
+  parameters p;
+  p.eta = in->eta; p.beta = in->beta; p.alpha = in->alpha;
+  p.delta = in->delta; p.mu = in->mu; p.rho = in->rho; p.sigma = in->sigma;
+  p.lambda = in->lambda; p.nk = in->nk; p.nz = in->nz; p.tol = in->tol;
+  p.zMethod = in->zMethod; p.pTol = in->pTol;
+  p.gamma = in->gamma; p.guard = in->guard;
+  return p;
+}
+
+int vfi_params_load(const char* fileName, vfiParams* param)
+{
+  std::ifstream test(fileName);
+  if(!test || param == NULL) return 1;
+  test.close();
+  parameters p;
+  p.load(fileName);
+  param->eta = p.eta; param->beta = p.beta; param->alpha = p.alpha;
+  param->delta = p.delta; param->mu = p.mu; param->rho = p.rho;
+  param->sigma = p.sigma; param->lambda = p.lambda; param->nk = p.nk;
+  param->nz = p.nz; param->tol = p.tol; param->zMethod = p.zMethod;
+  param->pTol = p.pTol; param->gamma = p.gamma; param->guard = p.guard;
+  return 0;
+}
+
+vfiSolver* vfi_create(const vfiParams* param)
+{
+  if(param == NULL || param->nk < 2 || param->nz < 2) return NULL;
+  try{
+    return new vfiSolver(toParameters(param));
+  } catch(...){
+    return NULL;
+  }
+}
+
+void vfi_destroy(vfiSolver* solver)
+{
+  delete solver;
+}
+
+int vfi_set_params(vfiSolver* solver, const vfiParams* param)
+{
+  if(solver == NULL || param == NULL || param->nk < 2 || param->nz < 2) return 1;
+  try{
+    solver->solver.setParameters(toParameters(param));
+  } catch(...){
+    return 1;
+  }
+  return 0;
+}
+
+int vfi_solve(vfiSolver* solver, double* V, int* G, const double* V0,
+	      int warm, vfiProgress progress, void* data)
+{
+  if(solver == NULL) return -1;
+  solveOptions opt;
+  opt.V = V;
+  opt.G = G;
+  opt.V0 = V0;
+  opt.warm = warm != 0;
+  opt.progress = progress;
+  opt.data = data;
+  try{
+    return solver->solver.solve(opt);
+  } catch(...){
+    return -1;
+  }
+}
+
+const double* vfi_value(const vfiSolver* solver)
+{
+  return solver->solver.value().data();
+}
+
+const int* vfi_policy(const vfiSolver* solver)
+{
+  return solver->solver.policy().data();
+}
+
+const double* vfi_kgrid(const vfiSolver* solver)
+{
+  return solver->solver.K().data();
+}
+
+const double* vfi_zgrid(const vfiSolver* solver)
+{
+  return solver->solver.Z().data();
+}
@@ -0,0 +1,93 @@
+/*****************************************************************************
+ *
+ * @file vfi.h
+ *
+ * @brief C interface to the embeddable value function iteration solver.
+ *
+ * @author Eric M. Aldrich \n
+ *         ealdrich@ucsc.edu
+ *
+ * @version 1.0
+ *
+ * @date 23 Oct 2012
+ *
+ * @copyright Copyright Eric M. Aldrich 2012 \n
+ *            Distributed under the Boost Software License, Version 1.0
+ *            (See accompanying file LICENSE_1_0.txt or copy at \n
+ *            http://www.boost.org/LICENSE_1_0.txt)
+ *
+ *****************************************************************************/
+
+#ifndef __FILE_VFI_H_SEEN__
+#define __FILE_VFI_H_SEEN__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Parameter values, in the order of the parameters class in global.h. */
+typedef struct vfiParams{
+  double eta; /**< Coefficient of relative risk aversion. */
+  double beta; /**< Time discount factor. */
+  double alpha; /**< Share of capital in the production function. */
+  double delta; /**< Rate of capital depreciation. */
+  double mu; /**< TFP mean. */
+  double rho; /**< TFP persistence. */
+  double sigma; /**< TFP volatility. */
+  double lambda; /**< Number of standard deviations for AR1 approximation. */
+  int nk; /**< Number of values in capital grid. */
+  int nz; /**< Number of values in TFP grid. */
+  double tol; /**< Tolerance for convergence. */
+  int zMethod; /**< Discretization of TFP: 0 Tauchen, 1 Tauchen-Hussey,
+		  2 Rouwenhorst. */
+  double pTol; /**< Truncation tolerance for TFP transition probabilities. */
+  double gamma; /**< Epstein-Zin risk aversion (0 for CRRA utility). */
+  int guard; /**< Nonzero to guard the maximization against
+		nonconcavity. */
+} vfiParams;
+
+/** Opaque solver handle. */
+typedef struct vfiSolver vfiSolver;
+
+/** Progress callback: iteration, sup-norm difference, user data; return
+    nonzero to stop iterating. */
+typedef int (*vfiProgress)(int iter, double diff, void* data);
+
+/** Load parameter values from a parameter file; returns 0 on success. */
+int vfi_params_load(const char* fileName, vfiParams* param);
+
+/** Create a solver for a calibration; returns NULL on failure. */
+vfiSolver* vfi_create(const vfiParams* param);
+
+/** Destroy a solver. */
+void vfi_destroy(vfiSolver* solver);
+
+/** Change the calibration, keeping the latest solution as a warm start;
+    returns 0 on success. */
+int vfi_set_params(vfiSolver* solver, const vfiParams* param);
+
+/** Solve the current calibration. V and G (nk*nz, column major) receive
+    the solution if not NULL; V0 (nk*nz) is the initial value function if
+    not NULL, otherwise the previous solution is used if warm is nonzero.
+    Returns the number of iterations, or -1 on failure. */
+int vfi_solve(vfiSolver* solver, double* V, int* G, const double* V0,
+	      int warm, vfiProgress progress, void* data);
+
+/** Latest value function (nk*nz, column major), valid until the next call
+    to vfi_solve, vfi_set_params or vfi_destroy. */
+const double* vfi_value(const vfiSolver* solver);
+
+/** Latest policy function (indices of the capital grid). */
+const int* vfi_policy(const vfiSolver* solver);
+
+/** Grid of capital values (nk). */
+const double* vfi_kgrid(const vfiSolver* solver);
+
+/** Grid of TFP values (nz). */
+const double* vfi_zgrid(const vfiSolver* solver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
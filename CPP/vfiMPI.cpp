@@ -0,0 +1,306 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file vfiMPI.cpp
+///
+/// @brief File containing main function for distributed value function
+/// iteration with MPI.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <mpi.h>
+#include <math.h>
+#include <Eigen/Dense>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <stdlib.h>
+
+using namespace std;
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @class kPartition
+///
+/// @brief Object to store the partition of the capital grid across ranks.
+///
+//////////////////////////////////////////////////////////////////////////////
+class kPartition{
+ public:
+  int rank; ///< Rank of this process.
+  int size; ///< Number of ranks.
+  int lo; ///< First capital index owned by this rank.
+  int n; ///< Number of capital indices owned by this rank.
+  vector<int> counts; ///< Number of values (n*nz) owned by each rank.
+  vector<int> displs; ///< Offset of the values owned by each rank.
+};
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to gather a row block of a matrix from all ranks.
+///
+/// @details Each rank packs its rows of X in capital major order, the
+/// blocks are gathered (on all ranks if root < 0, otherwise on root only)
+/// and unpacked into the columns of Y, so that each column of Y is
+/// contiguous in capital.
+///
+/// @param [in] part Partition of the capital grid.
+/// @param [in] X Rows of the matrix owned by this rank (n x nz).
+/// @param [in] type MPI datatype of the entries.
+/// @param [in] root Receiving rank, or -1 for all ranks.
+/// @param [in,out] buf Workspaces for the packed values.
+/// @param [out] Y Columns of the gathered matrix (nz vectors of length nk).
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+template<typename T, typename V>
+static void gatherRows(const kPartition& part, const Matrix<T,Dynamic,Dynamic>& X,
+		       MPI_Datatype type, const int root, vector<T>& buf,
+		       vector<V>& Y)
+{
+  const int nz = X.cols();
+  const int nk = Y[0].size();
+  vector<T> loc(part.n*nz);
+  for(int i = 0 ; i < part.n ; ++i){
+    for(int j = 0 ; j < nz ; ++j) loc[i*nz+j] = X(i,j);
+  }
+  buf.resize(nk*nz);
+  if(root < 0){
+    MPI_Allgatherv(loc.data(), part.n*nz, type, buf.data(), part.counts.data(),
+		   part.displs.data(), type, MPI_COMM_WORLD);
+  } else {
+    MPI_Gatherv(loc.data(), part.n*nz, type, buf.data(), part.counts.data(),
+		part.displs.data(), type, root, MPI_COMM_WORLD);
+    if(part.rank != root) return;
+  }
+  for(int j = 0 ; j < nz ; ++j){
+    for(int i = 0 ; i < nk ; ++i) Y[j](i) = buf[i*nz+j];
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to iterate the value function to convergence on a
+/// partitioned capital grid.
+///
+/// @details Each rank owns a contiguous block of the capital grid. At
+/// every iteration, a rank maximizes the Bellman objective at its own
+/// states with @link binaryMax @endlink, using the expected continuation
+/// values EV(k',j) = sum_l V0(k',l)*P(j,l) over the full grid of future
+/// capital. It then computes the rows of EV for its own block from its
+/// new value function, and the blocks of EV are all-gathered, so that a
+/// single collective of nk*nz values replaces the gather of V0 and the
+/// expectation stage is split across ranks. The sup norm of the change in
+/// the value function is all-reduced to test convergence. Under
+/// Epstein-Zin preferences, the rows of EV hold the transformed certainty
+/// equivalents of @link ezExp @endlink instead. Expectations use the
+/// banded transition matrix of @link pBand @endlink with tolerance
+/// param.pTol, as in @link vfStep @endlink, so that both solve the same
+/// Bellman equation. If param.guard is set,
+/// the maximization is guarded against nonconcavity by @link
+/// binaryMaxGuard @endlink.
+///
+/// @param [in] param Object of class parameters.
+/// @param [in] part Partition of the capital grid.
+/// @param [in] K Grid of capital values.
+/// @param [in] Z Grid of TFP values.
+/// @param [in] P TFP transition matrix.
+/// @param [in] V0 Initial value function (full grid).
+/// @param [out] V Converged value function at the rows of this rank.
+/// @param [out] G Converged policy function at the rows of this rank.
+///
+/// @returns Number of iterations performed.
+///
+//////////////////////////////////////////////////////////////////////////////
+static int vfSolveMPI(const parameters& param, const kPartition& part,
+		      const VectorXR& K, const VectorXR& Z, const MatrixXR& P,
+		      const MatrixXR& V0, MatrixXR& V, MatrixXi& G)
+{
+  const int nk = param.nk;
+  const int nz = param.nz;
+  const REAL eta = param.eta;
+  const REAL beta = param.beta;
+  const REAL alpha = param.alpha;
+  const REAL delta = param.delta;
+  const MPI_Datatype mpiReal = sizeof(REAL) == sizeof(double) ? MPI_DOUBLE : MPI_FLOAT;
+
+  // output and depreciated capital at the rows of this rank
+  const VectorXR Kloc = K.segment(part.lo, part.n);
+  MatrixXR ydepK = (Kloc.array().pow(alpha)).matrix()*Z.transpose();
+  ydepK.colwise() += (1-delta)*Kloc;
+
+  // banded approximation of the transition matrix, as in vfStep
+  MatrixXR Pt;
+  VectorXi plo, plen;
+  pBand(P, param.pTol, Pt, plo, plen);
+
+  // expected continuation values, one column per current TFP value
+  vector<VectorXR> EV(nz, VectorXR(nk));
+  MatrixXR EV0;
+  if(param.gamma > 0) ezExp(param, Pt, V0, EV0); else EV0 = V0*Pt.transpose();
+  for(int j = 0 ; j < nz ; ++j) EV[j] = EV0.col(j);
+
+  MatrixXR Vprev = V0.block(part.lo, 0, part.n, nz);
+  V.resize(part.n, nz);
+  G.resize(part.n, nz);
+  vector<REAL> buf;
+  REAL diff = 1.0, locDiff;
+  int khi, count = 0;
+  while(fabs(diff) > param.tol){
+
+    // maximization at the states of this rank
+    for(int i = 0 ; i < part.n ; ++i){
+      for(int j = 0 ; j < nz ; ++j){
+	khi = binaryVal(ydepK(i,j), K); // consumption nonnegativity
+	if(K[khi] > ydepK(i,j)) khi -= 1;
+	if(param.guard){
+	  binaryMaxGuard(0, khi+1, ydepK(i,j), eta, beta, K, EV[j], V(i,j),
+			 G(i,j));
+	} else {
+	  binaryMax(0, khi+1, ydepK(i,j), eta, beta, K, EV[j], V(i,j), G(i,j));
+	}
+      }
+    }
+
+    // convergence
+    locDiff = (V-Vprev).array().abs().maxCoeff();
+    MPI_Allreduce(&locDiff, &diff, 1, mpiReal, MPI_MAX, MPI_COMM_WORLD);
+    Vprev = V;
+    ++count;
+
+    // expectation stage for the rows of this rank, shared with all ranks
+    if(param.gamma > 0) ezExp(param, Pt, V, EV0); else EV0 = V*Pt.transpose();
+    gatherRows<REAL>(part, EV0, mpiReal, -1, buf, EV);
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @fn main()
+///
+/// @brief Main function for distributed value function iteration.
+///
+/// @details This function solves the neoclassical growth model of
+/// `main' with the capital grid partitioned across MPI ranks (see @link
+/// vfSolveMPI @endlink). Every rank computes the TFP and capital grids and
+/// the initial value function; the value and policy functions are gathered
+/// on rank 0, which writes them to `valFunMPI.dat' and `polFunMPI.dat' in
+/// the format of `main', and the solution time and number of ranks to
+/// `solTimeMPI.dat'.
+///
+/// @details Usage: `mpirun -np N ./vfiMPI'. As in `main', the
+/// maximization is guarded against nonconcavity if VFI_GUARD is a nonzero
+/// integer.
+///
+/// @returns 0 upon successful completion, 1 otherwise.
+///
+//////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  kPartition part;
+  MPI_Comm_rank(MPI_COMM_WORLD, &part.rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &part.size);
+
+  // admin
+  int i, j;
+  MPI_Barrier(MPI_COMM_WORLD);
+  double tic = curr_second(); // Start time
+
+  // Load parameters
+  parameters params;
+  params.load("../parameters.txt");
+  const char* guard = getenv("VFI_GUARD");
+  if(guard != NULL) params.guard = atoi(guard);
+  int nk = params.nk;
+  int nz = params.nz;
+  if(nk < part.size){
+    if(part.rank == 0) cerr << "More ranks than capital grid points" << endl;
+    MPI_Finalize();
+    return 1;
+  }
+
+  // partition the capital grid into nearly equal blocks
+  part.counts.resize(part.size);
+  part.displs.resize(part.size);
+  for(int r = 0 ; r < part.size ; ++r){
+    const int lo = (long)nk*r/part.size;
+    const int hi = (long)nk*(r+1)/part.size;
+    part.counts[r] = (hi-lo)*nz;
+    part.displs[r] = lo*nz;
+    if(r == part.rank){
+      part.lo = lo;
+      part.n = hi-lo;
+    }
+  }
+
+  // compute TFP grid, capital grid and initial VF
+  VectorXR K(nk);
+  VectorXR Z(nz);
+  MatrixXR P(nz, nz);
+  MatrixXR V0(nk, nz);
+  ar1(params, Z, P);
+  kGrid(params, Z, K);
+  vfInit(params, Z, V0);
+
+  // iterate
+  MatrixXR Vloc;
+  MatrixXi Gloc;
+  int iter = vfSolveMPI(params, part, K, Z, P, V0, Vloc, Gloc);
+
+  // gather the solution on rank 0
+  vector<VectorXR> V(nz, VectorXR(nk));
+  vector<VectorXi> G(nz, VectorXi(nk));
+  vector<REAL> bufV;
+  vector<int> bufG;
+  const MPI_Datatype mpiReal = sizeof(REAL) == sizeof(double) ? MPI_DOUBLE : MPI_FLOAT;
+  gatherRows<REAL>(part, Vloc, mpiReal, 0, bufV, V);
+  gatherRows<int>(part, Gloc, MPI_INT, 0, bufG, G);
+
+  // Compute solution time
+  double solTime = curr_second() - tic;
+
+  // write to file (column major)
+  if(part.rank == 0){
+    ofstream fileSolTime, fileValue, filePolicy;
+    fileValue.precision(10);
+    filePolicy.precision(10);
+    fileSolTime.open("solTimeMPI.dat");
+    fileValue.open("valFunMPI.dat");
+    filePolicy.open("polFunMPI.dat");
+    fileSolTime << solTime << endl;
+    fileSolTime << part.size << endl;
+    fileSolTime << iter << endl;
+    fileValue << nk << endl;
+    fileValue << nz << endl;
+    filePolicy << nk << endl;
+    filePolicy << nz << endl;
+    for(j = 0 ; j < nz ; ++j){
+      for(i = 0 ; i < nk ; ++i){
+	fileValue << V[j](i) << endl;
+	filePolicy << G[j](i) << endl;
+      }
+    }
+    fileSolTime.close();
+    fileValue.close();
+    filePolicy.close();
+  }
+
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,52 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file writeBin.cpp
+///
+/// @brief File containing function to write a matrix to a binary file.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <fstream>
+#include <Eigen/Dense>
+
+using namespace std;
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to write a matrix to a binary file.
+///
+/// @details The file layout mirrors the text output files: the number of
+/// rows and the number of columns (as 32-bit integers), followed by the
+/// matrix values in column major order (as REAL).
+///
+/// @param [in] fileName Name of output file.
+/// @param [in] X Matrix to write.
+///
+/// @returns Void.
+///
+//////////////////////////////////////////////////////////////////////////////
+void writeBin(const char* fileName, const MatrixXR& X)
+{
+  ofstream fileOut;
+  fileOut.open(fileName, ios::out | ios::binary);
+  const int nrow = X.rows();
+  const int ncol = X.cols();
+  fileOut.write((const char*)&nrow, sizeof(int));
+  fileOut.write((const char*)&ncol, sizeof(int));
+  fileOut.write((const char*)X.data(), sizeof(REAL)*nrow*ncol);
+  fileOut.close();
+}
@@ -0,0 +1,49 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @file zDraw.cpp
+///
+/// @brief File containing function to draw the next state of a Markov
+/// chain.
+///
+/// @author Eric M. Aldrich \n
+///         ealdrich@ucsc.edu
+///
+/// @version 1.0
+///
+/// @date 23 Oct 2012
+///
+/// @copyright Copyright Eric M. Aldrich 2012 \n
+///            Distributed under the Boost Software License, Version 1.0
+///            (See accompanying file LICENSE_1_0.txt or copy at \n
+///            http://www.boost.org/LICENSE_1_0.txt)
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "global.h"
+#include <Eigen/Dense>
+
+using namespace Eigen;
+
+//////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Function to draw the next index of a Markov chain.
+///
+/// @details The next index is the first l with u < Pc(j,l) (the last index
+/// if there is none), so that it is drawn from row j of the transition
+/// matrix. Used for TFP in the simulations and for idiosyncratic shocks in
+/// the heterogeneous agent models.
+///
+/// @param [in] u Uniform draw on [0,1).
+/// @param [in] j Current index.
+/// @param [in] Pc Cumulative transition matrix (column-wise sums).
+///
+/// @returns Next index.
+///
+//////////////////////////////////////////////////////////////////////////////
+int zDraw(const REAL& u, const int& j, const MatrixXR& Pc)
+{
+  const int n = Pc.cols();
+  int l = 0;
+  while(l < n-1 && u >= Pc(j,l)) ++l;
+  return l;
+}